@@ -64,6 +64,7 @@ private:
   
   size_t loadingCount;
   size_t loadQueuedId;
+  CancelToken loadCancel;
 
   refptr<DeviceProgram> texProgram;
   refptr<DeviceProgram> skeletonProgram;
@@ -95,6 +96,7 @@ public:
   virtual void SetTextureFilteringEnabled(bool enabled);
 
   virtual void Load(size_t id);
+  virtual void CancelLoad();
 
   virtual size_t GetActionCount() const;
   virtual const std::string& GetActionName() const;
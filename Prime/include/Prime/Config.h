@@ -121,6 +121,8 @@ extern void AssertCore(const char* file, u32 line, const char* f, ...);
 
 #define AlignMem(alignment, size) (((size) + (alignment) - 1) & ~((alignment) - 1))
 
+#define PrimeMapFileThreshold (256 * 1024)
+
 namespace Prime {
 
 typedef enum {
@@ -200,16 +202,27 @@ class Stack;
 extern f64 GetSystemTime();
 extern f64 GetTargetRTCSeconds();
 extern void* ReadFile(const std::string& uri, size_t* size);
-extern void ReadFile(const std::string& uri, const std::function<void (void*, size_t)>& callback);
+extern void ReadFile(const std::string& uri, const std::function<void (void*, size_t)>& callback, ogalib::JobPriority priority = ogalib::JobPriority::Normal);
+extern std::shared_ptr<const void> MapFile(const std::string& uri, size_t* size);
+extern void MapFile(const std::string& uri, const std::function<void (const std::shared_ptr<const void>&, size_t)>& callback, ogalib::JobPriority priority = ogalib::JobPriority::Normal);
+extern void ReadFileAhead(const std::string& uri);
 extern void GetContent(const std::string& uri, const std::function<void (Content*)>& callback);
 extern void GetContent(const std::string& uri, const json& info, const std::function<void (Content*)>& callback);
+extern void GetContent(const std::string& uri, const json& info, const ogalib::CancelToken& cancel, const std::function<void (Content*)>& callback);
 extern void GetContentRaw(const std::string& uri, const std::function<void (const void*, size_t)>& callback);
 extern void GetContentRaw(const std::string& uri, const json& info, const std::function<void (const void*, size_t)>& callback);
 extern void MapContentURI(const std::string& mappedURI, const std::string& uri);
 extern const std::string& GetMapppedContentURI(const std::string& uri);
 extern void GetPackFilenames(const std::string& uri, Stack<std::string>& filenames);
-extern bool LockSetjmpMutex();
-extern bool UnlockSetjmpMutex();
+extern void GetPackDirectoryFilenames(const std::string& uri, const std::string& directory, Stack<std::string>& filenames);
+extern void SetContentPrefetch(bool enabled);
+extern void SetContentReleaseDelay(f64 seconds);
+extern void SetContentCacheBudget(size_t bytes);
+extern json GetContentStats();
+extern void RegisterContentLoader(const std::function<bool (const void*, size_t, const json&)>& match, const std::function<Content* ()>& create);
+extern void RegisterContentClass(const std::string& className, const std::function<Content* ()>& create);
+extern void AddContentReferences(const json& references, const std::string& basePath = "");
+extern json GetContentReferences(const std::string& basePath = "");
 
 extern bool IsFormatJSON(const void* data, size_t dataSize, const json& info);
 extern bool IsFormatJSON(const void* data, size_t dataSize, const json& info, json& output);
@@ -224,10 +237,14 @@ extern bool IsFormatOTF(const void* data, size_t dataSize, const json& info);
 
 using ogalib::SetGlobalSendURLParams;
 using ogalib::SendURL;
+using ogalib::DataBuffer;
 using ogalib::string_printf;
 using ogalib::string_vprintf;
 using ogalib::Job;
 using ogalib::JobType;
+using ogalib::JobHandle;
+using ogalib::JobPriority;
+using ogalib::CancelToken;
 using ogalib::Thread;
 using ogalib::ThreadMutex;
 using ogalib::ThreadCondition;
@@ -65,6 +65,11 @@ public:
 
   virtual void GetWalkReferences(Stack<std::string>& paths) const;
 
+  virtual size_t GetCPUSize() const;
+  virtual size_t GetGPUSize() const;
+
+  void DecRef() override;
+
 };
 
 };
@@ -90,6 +90,7 @@ public:
   virtual void OnActivated(refptr<RefObject> object, refptr<ContentNodeInitParam> param);
 
   virtual void GetWalkReferences(Stack<std::string>& paths) const;
+  virtual size_t GetCPUSize() const;
 
   void AddJob(std::function<void(Job&)> callback, std::function<void(Job&)> response, JobType type) = delete;
   void AddJob(std::function<void(Job&)> callback, std::function<void(Job&)> response, const json& data = json(), JobType type = JobType::Default) = delete;
@@ -99,6 +100,8 @@ public:
   void GetContentRaw(const std::string& uri, const json& info, const std::function<void (const void*, size_t)>& callback) = delete;
   void SendURL(const std::string& url, const std::function<void(const json&)>& callback) = delete;
   void SendURL(const std::string& url, const json& params, const std::function<void(const json&)>& callback) = delete;
+  void SendURL(const std::string& url, const std::function<void(const json&, const DataBuffer&)>& callback) = delete;
+  void SendURL(const std::string& url, const json& params, const std::function<void(const json&, const DataBuffer&)>& callback) = delete;
 
 private:
 
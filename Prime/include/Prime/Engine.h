@@ -59,6 +59,7 @@ public:
 private:
 
   f64 lastFrameTime;
+  f64 jobTimeBudget;
   size_t currentFrame;
   bool running;
 
@@ -67,6 +68,10 @@ public:
   size_t GetCurrentFrame() const {return currentFrame;}
   bool IsRunning() const {return running;}
 
+  // Time StartFrame may spend on job responses; the rest carry over to later frames. Zero means no limit.
+  f64 GetJobTimeBudget() const {return jobTimeBudget;}
+  void SetJobTimeBudget(f64 jobTimeBudget) {this->jobTimeBudget = jobTimeBudget;}
+
 protected:
 
   Engine();
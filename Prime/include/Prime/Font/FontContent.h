@@ -238,6 +238,9 @@ public:
   virtual void AddChars(const char* start, const char* end = nullptr);
   virtual void CheckReload();
 
+  size_t GetCPUSize() const override;
+  size_t GetGPUSize() const override;
+
 public:
 
   static void GetDefaultValues(json& values);
@@ -82,6 +82,9 @@ public:
   virtual void SetSyncCount(size_t count);
   virtual void Sync();
 
+  virtual size_t GetCPUSize() const;
+  virtual size_t GetGPUSize() const;
+
 };
 
 };
@@ -437,6 +437,9 @@ public:
   virtual bool HasB() const;
   virtual bool HasA() const;
 
+  virtual size_t GetCPUSize() const;
+  virtual size_t GetGPUSize() const;
+
   static size_t GetPixelSize(TexFormat format);
   static bool LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData);
   static bool LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData);
@@ -199,6 +199,9 @@ public:
 
   virtual void Draw(size_t index = 0);
 
+  size_t GetCPUSize() const override;
+  size_t GetGPUSize() const override;
+
 protected:
 
   virtual void CreateBuffers();
@@ -57,6 +57,7 @@ public:
   bool Load(const json& data, const json& info) override;
   refptr<RefObject> Activate(const json& info) const override;
   void OnActivated(refptr<RefObject> object, refptr<ContentNodeInitParam> param) override;
+  void GetWalkReferences(Stack<std::string>& paths) const override;
 
 };
 
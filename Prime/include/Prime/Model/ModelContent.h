@@ -136,6 +136,9 @@ public:
 
   virtual void ApplyTextureToMesh(ModelContentMesh& mesh);
 
+  size_t GetCPUSize() const override;
+  size_t GetGPUSize() const override;
+
 };
 
 };
@@ -105,6 +105,9 @@ public:
   void SetLoadTextures(bool loadTextures);
   size_t GetMeshIndexByName(const std::string& name) const;
 
+  size_t GetCPUSize() const;
+  size_t GetGPUSize() const;
+
 protected:
 
   void ReadModelUsingTinyGLTF(const void* data, size_t dataSize);
@@ -56,6 +56,8 @@ public:
 public:
 
   bool Load(const json& data, const json& info) override;
+  void GetWalkReferences(Stack<std::string>& paths) const override;
+  size_t GetCPUSize() const override;
 
 };
 
@@ -229,6 +229,8 @@ public:
 public:
 
   bool Load(const json& data, const json& info) override;
+  void GetWalkReferences(Stack<std::string>& paths) const override;
+  size_t GetCPUSize() const override;
 
   virtual const SkeletonContentBone* FindBone(const std::string& name) const;
   virtual const SkeletonContentPose* FindPose(const std::string& name) const;
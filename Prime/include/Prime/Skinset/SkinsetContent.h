@@ -99,6 +99,7 @@ public:
   bool Load(const json& data, const json& info) override;
 
   void GetWalkReferences(Stack<std::string>& paths) const override;
+  size_t GetCPUSize() const override;
 
   virtual SkinsetContentAffixPieceLookupStack* CreateAffixPieceLookupStack(const std::string& affix);
   virtual const std::string& GetMappedAction(size_t pieceIndex, const std::string& actionName, const struct _SkeletonContentActionKeyFrame* actionKeyFrame = nullptr);
@@ -0,0 +1,98 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Structs
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+typedef struct {
+  char type[5];
+  const void* data;
+  uint32_t size;
+} PNGChunk;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+// Walks the chunks of an in-memory PNG by their headers only; no chunk
+// data is inflated, so locating an ancillary chunk costs a few reads per
+// chunk regardless of image size.
+class PNGChunkReader {
+private:
+
+  const uint8_t* data;
+  size_t dataSize;
+  size_t pos;
+  bool verifyCRC;
+  bool valid;
+  bool done;
+  PNGChunk chunk;
+
+public:
+
+  bool IsValid() const {return valid;}
+  bool IsDone() const {return done;}
+  const PNGChunk& GetChunk() const {return chunk;}
+
+public:
+
+  PNGChunkReader(const void* data, size_t dataSize, bool verifyCRC = true);
+  ~PNGChunkReader();
+
+public:
+
+  bool Next();
+  bool Find(const char* type);
+
+  static bool IsPNG(const void* data, size_t dataSize);
+  static bool FindChunk(const void* data, size_t dataSize, const char* type, PNGChunk& chunk);
+
+private:
+
+  bool Advance(bool checkCRC);
+  bool IsChunkAncillary() const;
+  bool IsChunkCRCValid() const;
+
+};
+
+};
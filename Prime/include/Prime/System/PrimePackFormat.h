@@ -32,6 +32,8 @@ SOFTWARE.
 
 #include <Prime/System/DataFile.h>
 #include <Prime/System/PrimePackFormatItem.h>
+#include <memory>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Enums
@@ -48,8 +50,89 @@ typedef enum {
   PrimePackFormatErrorInvalidFileSize,
   PrimePackFormatErrorContentNone,
   PrimePackFormatErrorChunkNotFoundInPNG,
+  PrimePackFormatErrorInvalidTable,
 } PrimePackFormatError;
 
+typedef enum {
+  PrimePackFormatCompressionNone = 0,
+  PrimePackFormatCompressionZlib,
+  PrimePackFormatCompressionZlibBlocks,
+} PrimePackFormatCompression;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Structs
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+// Version 3 layout, little endian: header, hashed table, entries, blocks,
+// metadata and strings up front, then item data aligned to header.alignment.
+// The table is open addressed with linear probing over entry indices keyed
+// by GetPathHash, with PrimePackFormatV3EmptySlot marking free slots.
+// ZlibBlocks items are split into blockSize chunks of uncompressed data,
+// each an independent zlib stream listed in the block table.
+
+#define PrimePackFormatV3HeaderOffset 16
+#define PrimePackFormatV3EmptySlot 0xFFFFFFFF
+
+typedef struct {
+  uint64_t fileSize;
+  uint32_t alignment;
+  uint32_t tableSize;
+  uint64_t itemCount;
+  uint64_t tableOffset;
+  uint64_t entriesOffset;
+  uint64_t blocksOffset;
+  uint64_t blockCount;
+  uint64_t metadataOffset;
+  uint64_t metadataCount;
+  uint64_t stringsOffset;
+  uint64_t stringsSize;
+  uint32_t packMetadataCount;
+  uint32_t reserved;
+} PrimePackFormatV3Header;
+
+typedef struct {
+  uint64_t hash;
+  uint32_t pathOffset;
+  uint32_t pathSize;
+  uint64_t size;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+  uint32_t binaryFormat;
+  uint32_t compression;
+  uint32_t blockSize;
+  uint32_t firstBlock;
+  uint32_t metadataIndex;
+  uint32_t metadataCount;
+} PrimePackFormatV3Entry;
+
+typedef struct {
+  uint64_t offset;
+  uint64_t size;
+} PrimePackFormatV3Block;
+
+typedef struct {
+  uint32_t nameOffset;
+  uint32_t nameSize;
+  uint32_t valueOffset;
+  uint32_t valueSize;
+} PrimePackFormatV3Metadata;
+
+static_assert(sizeof(PrimePackFormatV3Header) == 96, "PrimePackFormatV3Header must be 96 bytes");
+static_assert(sizeof(PrimePackFormatV3Entry) == 64, "PrimePackFormatV3Entry must be 64 bytes");
+
+typedef struct {
+  uint64_t size;
+  uint64_t dataSize;
+  uint64_t offset;
+  uint32_t compression;
+  uint32_t blockSize;
+  uint64_t firstBlock;
+} PrimePackFormatItemLocation;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,10 +145,9 @@ class PrimePackFormat {
 private:
 
   std::string contentPath;
-  BlockBuffer* ppfData;
-
-  void* loadChunk;
-  size_t loadChunkSize;
+  std::shared_ptr<const void> ppfBuffer;
+  const uint8_t* ppfBytes;
+  size_t ppfSize;
 
   uint32_t version;
   std::unordered_map<std::string, PrimePackFormatItem*> items;
@@ -73,13 +155,19 @@ private:
   std::unordered_map<std::string, std::string> metadata;
   PrimePackFormatError error;
 
+  PrimePackFormatV3Header v3Header;
+
+  mutable std::unordered_map<std::string, std::vector<std::string>> directories;
+  mutable bool directoriesValid;
+
 public:
 
   bool IsValid() const {return error == PrimePackFormatErrorNone;}
-  bool HasItems() const {return items.size() > 0 || addedItems.size() > 0;}
+  bool HasItems() const {return items.size() > 0 || addedItems.size() > 0 || v3Header.itemCount > 0;}
   uint32_t GetVersion() const {return version;}
   const std::unordered_map<std::string, std::string>& GetMetadata() const {return metadata;}
   const std::string& GetContentPath() const {return contentPath;}
+  const std::shared_ptr<const void>& GetBuffer() const {return ppfBuffer;}
   PrimePackFormatError GetError() const {return error;}
 
 public:
@@ -92,22 +180,37 @@ public:
 public:
 
   void InitFromData(const void* data, size_t dataSize);
-  void SetLoadChunk(const void* chunk, size_t chunkSize);
+  void InitFromData(const std::shared_ptr<const void>& dataBuffer, size_t dataSize);
+  void InitFromFile(const std::string& path);
   void SetContentPath(const std::string& contentPath);
 
   bool HasItem(const std::string& path) const;
   size_t GetItemCount() const;
 
   void GetItemPaths(std::vector<std::string>& paths) const;
+  void GetDirectoryPaths(const std::string& directory, std::vector<std::string>& paths) const;
   BlockBuffer* GetItemData(const std::string& path, size_t blockSize = 0) const;
+  const void* GetItemSpan(const std::string& path, size_t* size = nullptr) const;
+  void* GetItemBytes(const std::string& path, size_t* size = nullptr) const;
+  size_t ReadItem(const std::string& path, uint64_t offset, void* p, size_t size) const;
 
   void AddItem(const std::string& path, void* data, size_t dataSize, bool replace = false);
   void AddItem(const std::string& path, const std::string& data, bool replace = false);
 
+  static uint64_t GetPathHash(const std::string& path);
+
 private:
 
   PrimePackFormatError ParseVersion1(DataFile& file);
   PrimePackFormatError ParseVersion2(DataFile& file);
+  PrimePackFormatError ParseVersion3();
+
+  bool FindItem(const std::string& path, PrimePackFormatItemLocation& location) const;
+  bool FindEntry(const std::string& path, PrimePackFormatV3Entry& entry) const;
+  bool ReadEntry(uint64_t index, PrimePackFormatV3Entry& entry) const;
+  std::string ReadString(uint64_t offset, uint64_t size) const;
+  bool InflateBlock(const PrimePackFormatItemLocation& location, uint64_t block, void* p) const;
+  void BuildDirectories() const;
 
 };
 
@@ -0,0 +1,122 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Prime/System/PrimePackFormat.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+#define PrimePackFormatWriterDefaultAlignment 4096
+#define PrimePackFormatWriterDefaultBlockSize (64 * 1024)
+#define PrimePackFormatWriterDefaultCompressionLevel 9
+#define PrimePackFormatWriterDefaultMinCompressionRatio 0.9f
+
+////////////////////////////////////////////////////////////////////////////////
+// Structs
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+typedef struct {
+  size_t itemCount;
+  size_t uniqueItemCount;
+  size_t compressedItemCount;
+  uint64_t itemSize;
+  uint64_t dataSize;
+  uint64_t fileSize;
+} PrimePackFormatWriterStats;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+// Builds version 3 packs. Items are laid out in the order given to SetOrder,
+// then by path; identical items share one copy of their data.
+class PrimePackFormatWriter {
+private:
+
+  typedef struct {
+    std::string path;
+    std::vector<uint8_t> data;
+  } Item;
+
+  std::vector<Item> items;
+  std::unordered_map<std::string, size_t> itemIndices;
+  std::vector<std::pair<std::string, std::string>> metadata;
+  std::unordered_map<std::string, size_t> order;
+
+  uint32_t alignment;
+  uint32_t blockSize;
+  int compressionLevel;
+  float minCompressionRatio;
+
+  PrimePackFormatWriterStats stats;
+
+public:
+
+  size_t GetItemCount() const {return items.size();}
+  const PrimePackFormatWriterStats& GetStats() const {return stats;}
+
+  void SetAlignment(uint32_t alignment) {this->alignment = alignment;}
+  void SetBlockSize(uint32_t blockSize) {this->blockSize = blockSize;}
+  void SetCompressionLevel(int compressionLevel) {this->compressionLevel = compressionLevel;}
+  void SetMinCompressionRatio(float minCompressionRatio) {this->minCompressionRatio = minCompressionRatio;}
+
+public:
+
+  PrimePackFormatWriter();
+  ~PrimePackFormatWriter();
+
+public:
+
+  void AddItem(const std::string& path, const void* data, size_t dataSize, bool replace = false);
+  void AddItem(const std::string& path, std::vector<uint8_t>&& data, bool replace = false);
+  bool HasItem(const std::string& path) const;
+
+  void SetMetadata(const std::string& name, const std::string& value);
+  void SetOrder(const std::vector<std::string>& paths);
+
+  bool Write(std::vector<uint8_t>& ppf);
+
+  static bool EmbedInPNG(const void* png, size_t pngSize, const void* ppf, size_t ppfSize, std::vector<uint8_t>& result);
+
+};
+
+};
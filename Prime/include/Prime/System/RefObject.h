@@ -75,10 +75,15 @@ public:
   void AddJob(std::function<void(Job&)> callback, std::function<void(Job&)> response, const json& data = json(), JobType type = JobType::Default);
   void GetContent(const std::string& uri, const std::function<void (Content*)>& callback);
   void GetContent(const std::string& uri, const json& info, const std::function<void (Content*)>& callback);
+  void GetContent(const std::string& uri, const json& info, const CancelToken& cancel, const std::function<void (Content*)>& callback);
   void GetContentRaw(const std::string& uri, const std::function<void (const void*, size_t)>& callback);
   void GetContentRaw(const std::string& uri, const json& info, const std::function<void (const void*, size_t)>& callback);
   void SendURL(const std::string& url, const std::function<void(const json&)>& callback);
   void SendURL(const std::string& url, const json& params, const std::function<void(const json&)>& callback);
+  void SendURL(const std::string& url, const std::function<void(const json&, const DataBuffer&)>& callback);
+  void SendURL(const std::string& url, const json& params, const std::function<void(const json&, const DataBuffer&)>& callback);
+  void SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&)>& callback);
+  void SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&, const DataBuffer&)>& callback);
 
 };
 
@@ -0,0 +1,105 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Prime/Config.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+#define PrimeFileReadQueueMaxBatches 4
+#define PrimeFileReadQueueMaxBatchSize 32
+#define PrimeFileReadQueueMapThreshold PrimeMapFileThreshold
+#define PrimeFileReadQueueReadAheadCount 32
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+class FileReadRequest;
+
+// Reads whole files in batches on IO jobs, highest priority first. A batch
+// opens its files, starts kernel read-ahead for all of them, then reads them
+// together: one io_uring submission where the kernel allows it, otherwise
+// preads in turn. Files at or above the map threshold are mapped instead
+// when the caller can take a mapping. Queued files beyond the running
+// batches are opened and hinted ahead of time, so the disk stays busy while
+// responses are handled.
+class FileReadQueue {
+private:
+
+  ThreadMutex mutex;
+  std::deque<std::shared_ptr<FileReadRequest>> queues[3];
+  size_t activeBatches;
+  size_t maxBatches;
+  size_t maxBatchSize;
+  size_t mapThreshold;
+  size_t readAheadCount;
+
+  size_t started[3];
+  double maxWaitTime[3];
+  size_t batches;
+  size_t ringBatches;
+  size_t readAheads;
+  uint64_t bytesRead;
+  uint64_t bytesMapped;
+
+public:
+
+  FileReadQueue(size_t maxBatches, size_t maxBatchSize, size_t mapThreshold, size_t readAheadCount);
+  ~FileReadQueue();
+
+public:
+
+  void Read(const std::string& path, JobPriority priority, const std::function<void (void*, size_t)>& callback);
+  void Map(const std::string& path, JobPriority priority, const std::function<void (const std::shared_ptr<const void>&, size_t)>& callback);
+  void ReadAhead(const std::string& path);
+
+  json GetStats();
+
+private:
+
+  void Enqueue(const std::shared_ptr<FileReadRequest>& request);
+  void Dispatch();
+  void StartBatch(const std::shared_ptr<std::vector<std::shared_ptr<FileReadRequest>>>& batch);
+  void ReadBatch(std::vector<std::shared_ptr<FileReadRequest>>& batch);
+  void HintQueued();
+
+};
+
+};
@@ -0,0 +1,104 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/Thread.h>
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class AssetCacheItem {
+public:
+
+  std::string url;
+  std::string md5URL;
+  std::string format;
+  DataBuffer data;
+
+};
+
+class AssetCache {
+private:
+
+  class Entry {
+  public:
+
+    AssetCacheItem item;
+    std::list<std::string>::iterator lru;
+
+  };
+
+  class Shard {
+  public:
+
+    ThreadMutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru;
+
+  };
+
+private:
+
+  std::vector<Shard*> shards;
+  size_t maxSize;
+  std::atomic<size_t> size;
+  std::atomic<size_t> count;
+  std::atomic<size_t> hits;
+  std::atomic<size_t> misses;
+  std::atomic<size_t> evictions;
+
+public:
+
+  AssetCache(size_t maxSize, size_t shardCount);
+  ~AssetCache();
+
+public:
+
+  bool Get(const std::string& key, AssetCacheItem& item);
+  void Set(const std::string& key, const AssetCacheItem& item);
+  void Clear();
+  json GetStats() const;
+
+private:
+
+  Shard& GetShard(const std::string& key);
+  bool EvictOne(Shard& shard, const std::string& keepKey);
+
+};
+
+};
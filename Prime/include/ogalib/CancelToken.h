@@ -0,0 +1,76 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/Thread.h>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class CancelState;
+
+// Shared flag for abandoning work that is no longer wanted. Copies share the
+// same state. A default constructed token is empty and never cancels.
+class CancelToken {
+private:
+
+  std::shared_ptr<CancelState> state;
+
+public:
+
+  CancelToken();
+
+public:
+
+  static CancelToken Create();
+
+  bool IsValid() const {return state != nullptr;}
+  bool IsCancelled() const;
+  void Cancel() const;
+
+  // Called on the thread that cancels, or right away if already cancelled.
+  // Returns an id for RemoveOnCancel, or 0 when nothing was registered.
+  size_t OnCancel(const std::function<void()>& callback) const;
+  void RemoveOnCancel(size_t id) const;
+
+  bool operator==(const CancelToken& other) const {return state == other.state;}
+  bool operator!=(const CancelToken& other) const {return state != other.state;}
+
+};
+
+};
@@ -34,10 +34,58 @@ SOFTWARE.
 #define OGALIB_API_ROOT "https://ogahub.com/API"
 #endif
 
+// 0 starts one worker per device thread, less one for the main thread.
 #ifndef OGALIB_JOB_CALLBACK_WORKER_COUNT
-#define OGALIB_JOB_CALLBACK_WORKER_COUNT 3
+#define OGALIB_JOB_CALLBACK_WORKER_COUNT 0
+#endif
+
+#ifndef OGALIB_JOB_IO_WORKER_COUNT
+#define OGALIB_JOB_IO_WORKER_COUNT 8
+#endif
+
+#ifndef OGALIB_JOB_INLINE_SIZE
+#define OGALIB_JOB_INLINE_SIZE 64
 #endif
 
 #ifndef OGALIB_JOB_CALLBACK_WORKER_THREAD_PRIORITY
 #define OGALIB_JOB_CALLBACK_WORKER_THREAD_PRIORITY (-1.0f)
 #endif
+
+#ifndef OGALIB_URL_MAX_REQUESTS
+#define OGALIB_URL_MAX_REQUESTS OGALIB_JOB_IO_WORKER_COUNT
+#endif
+
+#ifndef OGALIB_URL_MAX_REQUESTS_PER_HOST
+#define OGALIB_URL_MAX_REQUESTS_PER_HOST 6
+#endif
+
+// Request slots that low priority (prefetch) requests may not take.
+#ifndef OGALIB_URL_FOREGROUND_RESERVED
+#define OGALIB_URL_FOREGROUND_RESERVED 2
+#endif
+
+// While foreground requests are waiting, one in this many starts goes to a waiting prefetch request.
+#ifndef OGALIB_URL_PREFETCH_SHARE
+#define OGALIB_URL_PREFETCH_SHARE 4
+#endif
+
+#ifndef OGALIB_ASSET_CACHE_MAX_SIZE
+#define OGALIB_ASSET_CACHE_MAX_SIZE (64 * 1024 * 1024)
+#endif
+
+#ifndef OGALIB_ASSET_CACHE_SHARD_COUNT
+#define OGALIB_ASSET_CACHE_SHARD_COUNT 16
+#endif
+
+#ifndef OGALIB_ASSET_DISK_CACHE_MAX_SIZE
+#define OGALIB_ASSET_DISK_CACHE_MAX_SIZE (256 * 1024 * 1024)
+#endif
+
+// Stores between index saves. The index is always saved on shutdown.
+#ifndef OGALIB_ASSET_DISK_CACHE_INDEX_SAVE_INTERVAL
+#define OGALIB_ASSET_DISK_CACHE_INDEX_SAVE_INTERVAL 16
+#endif
+
+#ifndef OGALIB_LINUX_URL_MAX_CONNECTIONS_PER_HOST
+#define OGALIB_LINUX_URL_MAX_CONNECTIONS_PER_HOST 6
+#endif
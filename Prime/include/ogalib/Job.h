@@ -31,7 +31,15 @@ SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <ogalib/Thread.h>
+#include <ogalib/CancelToken.h>
 #include <functional>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <new>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Classes
@@ -41,57 +49,379 @@ namespace ogalib {
 
 enum class JobType {
   Default = 0,
-  Independent = 1,
+  Independent = 1, // Same as IO; jobs no longer get a thread of their own.
   Express = 2,
+  IO = 3,
+};
+
+// Order in which completed jobs have their responses called on the main thread.
+enum class JobPriority {
+  Low = 0,
+  Normal = 1,
+  High = 2,
+};
+
+class Job;
+class JobState;
+
+// Move-only callable stored inline when it fits, so most jobs never allocate for their callbacks.
+class JobFunction {
+private:
+
+  struct Ops {
+    void (*call)(void* target, Job& job);
+    void (*move)(void* dst, void* src);
+    void (*destroy)(void* target);
+    bool inlined;
+  };
+
+  template<typename F>
+  struct OpsFor {
+    static const bool inlined = sizeof(F) <= OGALIB_JOB_INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value;
+
+    static void Call(void* target, Job& job) {(*static_cast<F*>(target))(job);}
+    static void Move(void* dst, void* src) {if constexpr(inlined) {new (dst) F(std::move(*static_cast<F*>(src))); static_cast<F*>(src)->~F();}}
+    static void Destroy(void* target) {if constexpr(inlined) static_cast<F*>(target)->~F(); else delete static_cast<F*>(target);}
+
+    static const Ops ops;
+  };
+
+  alignas(std::max_align_t) unsigned char storage[OGALIB_JOB_INLINE_SIZE];
+  void* target;
+  const Ops* ops;
+
+public:
+
+  JobFunction(): target(nullptr), ops(nullptr) {}
+  JobFunction(std::nullptr_t): target(nullptr), ops(nullptr) {}
+
+  template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, JobFunction>::value>::type>
+  JobFunction(F&& f): target(nullptr), ops(nullptr) {
+    typedef typename std::decay<F>::type Callable;
+    if(!IsCallable(f))
+      return;
+
+    if constexpr(OpsFor<Callable>::inlined) {
+      target = new (storage) Callable(std::forward<F>(f));
+    }
+    else {
+      target = new Callable(std::forward<F>(f));
+    }
+    ops = &OpsFor<Callable>::ops;
+  }
+
+  JobFunction(JobFunction&& other): target(nullptr), ops(nullptr) {
+    *this = std::move(other);
+  }
+
+  JobFunction(const JobFunction& other) = delete;
+
+  ~JobFunction() {
+    Reset();
+  }
+
+public:
+
+  JobFunction& operator=(JobFunction&& other) {
+    if(this != &other) {
+      Reset();
+      if(other.ops) {
+        if(other.ops->inlined) {
+          other.ops->move(storage, other.target);
+          target = storage;
+        }
+        else {
+          target = other.target;
+        }
+        ops = other.ops;
+        other.target = nullptr;
+        other.ops = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  JobFunction& operator=(const JobFunction& other) = delete;
+
+  explicit operator bool() const {return ops != nullptr;}
+
+  void operator()(Job& job) {
+    ops->call(target, job);
+  }
+
+  void Reset() {
+    if(ops) {
+      ops->destroy(target);
+      target = nullptr;
+      ops = nullptr;
+    }
+  }
+
+private:
+
+  template<typename F>
+  static bool IsCallable(const F& f) {return true;}
+
+  template<typename R, typename... Args>
+  static bool IsCallable(const std::function<R(Args...)>& f) {return (bool) f;}
+
+};
+
+template<typename F>
+const JobFunction::Ops JobFunction::OpsFor<F>::ops = {
+  &JobFunction::OpsFor<F>::Call,
+  &JobFunction::OpsFor<F>::Move,
+  &JobFunction::OpsFor<F>::Destroy,
+  JobFunction::OpsFor<F>::inlined,
+};
+
+// Typed result handed from a job's callback to its response, stored inline when it fits.
+class JobValue {
+private:
+
+  template<typename T>
+  struct Tag {
+    static const char id = 0;
+  };
+
+  alignas(std::max_align_t) unsigned char storage[OGALIB_JOB_INLINE_SIZE];
+  void* value;
+  const void* type;
+  void (*destroy)(void* value, bool inlined);
+
+public:
+
+  JobValue(): value(nullptr), type(nullptr), destroy(nullptr) {}
+  JobValue(const JobValue& other) = delete;
+
+  ~JobValue() {
+    Reset();
+  }
+
+public:
+
+  JobValue& operator=(const JobValue& other) = delete;
+
+  bool IsEmpty() const {return value == nullptr;}
+
+  template<typename T>
+  bool Is() const {return type == &Tag<T>::id;}
+
+  template<typename T, typename... Args>
+  T& Emplace(Args&&... args) {
+    Reset();
+
+    if constexpr(sizeof(T) <= OGALIB_JOB_INLINE_SIZE && alignof(T) <= alignof(std::max_align_t)) {
+      value = new (storage) T(std::forward<Args>(args)...);
+    }
+    else {
+      value = new T(std::forward<Args>(args)...);
+    }
+
+    type = &Tag<T>::id;
+    destroy = [](void* value, bool inlined) {
+      if(inlined)
+        static_cast<T*>(value)->~T();
+      else
+        delete static_cast<T*>(value);
+    };
+
+    return *static_cast<T*>(value);
+  }
+
+  template<typename T>
+  T& Get() {
+    ogalibAssert(Is<T>(), "Job value holds a different type.");
+    return *static_cast<T*>(value);
+  }
+
+  void Reset() {
+    if(value) {
+      destroy(value, value == storage);
+      value = nullptr;
+      type = nullptr;
+      destroy = nullptr;
+    }
+  }
+
+};
+
+template<typename T>
+const char JobValue::Tag<T>::id;
+
+// Job payload json, created on first use so jobs that never touch it do not allocate one.
+class JobData {
+private:
+
+  json* value;
+
+public:
+
+  JobData(): value(nullptr) {}
+  JobData(const json& v): value(v.IsNull() ? nullptr : new json(v)) {}
+  JobData(const JobData& other) = delete;
+
+  ~JobData() {
+    if(value)
+      delete value;
+  }
+
+public:
+
+  JobData& operator=(const JobData& other) = delete;
+
+  operator json&() {return get();}
+  operator const json&() const {return value ? *value : GetNull();}
+
+  json::iterator operator[](const char* key) {return get()[key];}
+  json::iterator operator[](const std::string& key) {return get()[key];}
+
+  json::iterator find(const char* key) {return get().find(key);}
+  json::iterator find(const std::string& key) {return get().find(key);}
+
+  json& erase(const json::iterator& it) {return get().erase(it);}
+
+  std::string tostring() const {return value ? value->tostring() : GetNull().tostring();}
+
+  bool IsAllocated() const {return value != nullptr;}
+
+  json& get() {
+    if(!value)
+      value = new json();
+    return *value;
+  }
+
+private:
+
+  static const json& GetNull() {
+    static const json null;
+    return null;
+  }
+
+};
+
+// Completes once the job's callback has run, before its response reaches the main thread.
+class JobHandle {
+friend class Job;
+private:
+
+  std::shared_ptr<JobState> state;
+
+public:
+
+  bool IsValid() const {return state != nullptr;}
+  bool IsCompleted() const;
+
+  void Wait() const;
+
+  JobHandle Then(JobFunction callback, JobType type = JobType::Default) const;
+  JobHandle Then(JobFunction callback, JobFunction response, JobType type = JobType::Default) const;
+
 };
 
 class Job {
 friend void Init(const json& params);
 friend void Shutdown();
 friend void Process();
-friend void* JobThread(void*);
+friend void Process(double jobTimeBudget);
 friend void* JobWorkerThread(void*);
+friend void* JobIOWorkerThread(void*);
+friend class JobStack;
+friend class JobHandle;
 private:
 
-  std::function<void(Job&)> callback;
-  std::function<void(Job&)> response;
-  ogalib::Thread* thread;
+  JobFunction callback;
+  JobFunction response;
+  JobValue result;
   bool completed;
   JobType type;
+  std::atomic<JobPriority> priority;
+  Job* next;
+  std::shared_ptr<JobState> state;
+  std::atomic<size_t> pendingDependencies;
+  CancelToken cancel;
 
 public:
 
-  json data;
+  JobData data;
   void* param;
   std::string error;
 
 public:
 
-  Job(std::function<void(Job&)> callback, std::function<void(Job&)> response, JobType type);
-  Job(std::function<void(Job&)> callback, std::function<void(Job&)> response, const json& data = json(), JobType type = JobType::Default);
+  Job(JobFunction callback, JobFunction response, JobType type = JobType::Default);
+  Job(JobFunction callback, JobFunction response, const json& data, JobType type = JobType::Default);
+
+  // The callback is skipped once the token is cancelled. The response is still called so callers can clean up.
+  Job(JobFunction callback, JobFunction response, const CancelToken& cancel, JobType type = JobType::Default);
+
+  // The priority is set before the job is submitted.
+  Job(JobFunction callback, JobFunction response, JobPriority priority, JobType type = JobType::Default);
   ~Job();
 
+  // Jobs are recycled through a free list instead of the heap.
+  static void* operator new(size_t size);
+  static void operator delete(void* p);
+
 private:
 
-  void InitCommon();
+  Job(JobFunction callback, JobFunction response, const json* data, JobType type, const std::vector<JobHandle>& dependencies);
+
+  void InitCommon(const std::vector<JobHandle>& dependencies = std::vector<JobHandle>());
+  void DependencyCompleted();
+  void Submit();
+  void Execute();
 
 public:
 
   void Call(void* param = nullptr, const std::string& error = std::string());
 
+  // Typed alternative to data for passing a result from the callback to the response.
+  template<typename T>
+  void SetResult(const T& value) {result.Emplace<typename std::decay<T>::type>(value);}
+
+  template<typename T>
+  void SetResult(T&& value) {result.Emplace<typename std::decay<T>::type>(std::forward<T>(value));}
+
+  template<typename T>
+  T& GetResult() {return result.Get<T>();}
+
+  bool HasResult() const {return !result.IsEmpty();}
+
+  const CancelToken& GetCancelToken() const {return cancel;}
+  bool IsCancelled() const {return cancel.IsCancelled();}
+
+  JobPriority GetPriority() const {return priority;}
+  void SetPriority(JobPriority priority) {this->priority = priority;}
+
 public:
 
   static bool HasJobs();
 
+  // Blocks the main thread until a completed job is waiting for its response, or no jobs remain.
+  static void WaitForResponses();
+  static json GetStats();
+
+  static JobHandle Start(JobFunction callback, JobType type = JobType::Default);
+  static JobHandle Start(JobFunction callback, JobFunction response, const std::vector<JobHandle>& dependencies, JobType type = JobType::Default);
+  static JobHandle Start(JobFunction callback, JobFunction response, const std::vector<JobHandle>& dependencies, const json& data, JobType type = JobType::Default);
+  static JobHandle WhenAll(const std::vector<JobHandle>& handles);
+
+  // Splits [begin, end) into chunks run across the workers, and returns once all have run.
+  // The calling thread runs chunks too, so this is safe to call from inside a job.
+  static void ParallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& callback, size_t grainSize = 0);
+
 private:
 
   static void InitGlobal();
   static void ShutdownGlobal();
-  static void ProcessGlobal();
+  static void ProcessGlobal(double timeBudget = 0.0);
 
   static void InitWorkerThread();
   static void ShutdownWorkerThread();
 
+  static void WaitUntil(const std::function<bool()>& done);
+
 };
 
 };
@@ -31,6 +31,8 @@ SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <ogalib/rapidjson_include.h>
+#include <memory>
+#include <string>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Defines
@@ -48,6 +50,9 @@ namespace ogalib {
 
 void AssertCore(const char* file, uint32_t line, const char* f, ...);
 
+// Immutable, reference counted bytes.
+typedef std::shared_ptr<const std::string> DataBuffer;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,7 +31,13 @@ SOFTWARE.
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <ogalib/Job.h>
+#include <ogalib/Event.h>
+#include <ogalib/AssetCache.h>
+#include <ogalib/URLScheduler.h>
 #include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Defines
@@ -45,6 +51,8 @@ SOFTWARE.
 
 namespace ogalib {
 
+class AssetDownload;
+
 class Data {
 public:
 
@@ -57,17 +65,24 @@ public:
   bool encodeURLRequests;
 
   bool loginInProgress;
+  Event* loginDone;
   size_t userId;
   size_t token;
 
-  json assetCache;
-  json assetCacheInProgress;
+  URLScheduler* urlScheduler;
+
+  AssetCache* assetCache;
+  std::unordered_map<std::string, std::shared_ptr<AssetDownload>> assetCacheInProgress;
   ThreadMutex* assetCacheMutex;
 
 public:
 
   Data();
 
+public:
+
+  void SetLoginInProgress(bool loginInProgress);
+
 };
 
 };
@@ -81,6 +96,7 @@ namespace ogalib {
 void Init(const json& params = json());
 void Shutdown();
 void Process();
+void Process(double jobTimeBudget);
 bool IsInitialized();
 
 // General Configuration
@@ -93,8 +109,18 @@ void SendURL(const std::string& url);
 void SendURL(const std::string& url, const json& params);
 void SendURL(const std::string& url, const std::function<void(const json&)>& callback);
 void SendURL(const std::string& url, const json& params, const std::function<void(const json&)>& callback);
-bool SendURL(const std::string& url, const json& params, json& result);
+void SendURL(const std::string& url, const json& params, const std::function<void(const json&, const DataBuffer&)>& callback);
+// Asynchronous requests are queued by params "priority": "low" (prefetch), "normal" or "high".
+URLRequestHandle SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&)>& callback);
+URLRequestHandle SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&, const DataBuffer&)>& callback);
+bool SendURL(const std::string& url, const json& params, json& result, const CancelToken& cancel = CancelToken());
+bool SendURL(const std::string& url, const json& params, json& result, std::string& response, const CancelToken& cancel = CancelToken());
 void GetAssetByURL(const std::string& url, std::function<void(const json&)> callback = nullptr);
+void GetAssetByURL(const std::string& url, std::function<void(const json&, const DataBuffer&)> callback);
+void GetAssetByURL(const std::string& url, const CancelToken& cancel, std::function<void(const json&, const DataBuffer&)> callback);
+json GetAssetCacheStats();
+json GetURLSchedulerStats();
+json GetAssetDiskCacheStats();
 
 // User Login and Session
 void Login(std::function<void(const json&)> callback = nullptr);
@@ -120,5 +146,6 @@ std::string string_printf(const char* f, ...);
 std::string string_vprintf(const char* f, va_list ap, va_list ap2);
 std::string EncodeURL(const char* f, ...);
 std::string DecodeURL(const char* f);
+void ParseURLResponseHeaders(const char* headers, size_t headersSize, json& result);
 
 };
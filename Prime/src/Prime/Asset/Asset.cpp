@@ -112,7 +112,9 @@ void Asset::Load(size_t id) {
     return;
 
   if(loadingCount > 0) {
+    // Abandon the current load. The new one starts once its callbacks have all come back.
     loadQueuedId = id;
+    CancelLoad();
     return;
   }
 
@@ -128,9 +130,21 @@ void Asset::Load(size_t id) {
   dataManifest.array();
   dataManifestAssets.Clear();
 
+  loadCancel = CancelToken::Create();
+  CancelToken cancel = loadCancel;
+
+  // The asset being viewed goes ahead of the assets in its data manifest.
+  std::string priority = parent ? "normal" : "high";
+  json params = {{"priority", priority}};
+
   IncLoading();
-  SendURL(string_printf("%s/GetAssetInfo/v1/?id=%d", useAPIRoot.c_str(), id), [=](const json& response) {
-    if(auto it = response.find("data")) {
+  SendURL(string_printf("%s/GetAssetInfo/v1/?id=%d", useAPIRoot.c_str(), id), params, cancel, [=](const json& response) {
+    if(cancel.IsCancelled()) {
+      DecLoading();
+      return;
+    }
+
+    if(auto it = response.find("response")) {
       if(info.parse(it.cstr())) {
         if(auto itParentURL = info.find("parentURL")) {
           std::string parentURI = itParentURL.GetString();
@@ -140,8 +154,13 @@ void Asset::Load(size_t id) {
         }
 
         IncLoading();
-        SendURL(string_printf("%s/GetAssetDataManifest/v1/?id=%d", useAPIRoot.c_str(), id), [=](const json& response) {
-          if(auto it = response.find("data")) {
+        SendURL(string_printf("%s/GetAssetDataManifest/v1/?id=%d", useAPIRoot.c_str(), id), params, cancel, [=](const json& response) {
+          if(cancel.IsCancelled()) {
+            DecLoading();
+            return;
+          }
+
+          if(auto it = response.find("response")) {
             if(dataManifest.parse(it.cstr())) {
               // Load the main asset.
               std::string loadURL;
@@ -238,7 +257,12 @@ void Asset::Load(size_t id) {
 
                     // No url or data manifest found.  Go to the original asset and load that.
                     IncLoading();
-                    GetContent(loadURL, info, [=](Content* content) {
+                    GetContent(loadURL, info + json({{"_priority", priority}}), cancel, [=](Content* content) {
+                      if(!content || cancel.IsCancelled()) {
+                        DecLoading();
+                        return;
+                      }
+
                       if(content->IsInstance<ImagemapContent>()) {
                         auto newImagemap = new Imagemap();
                         imagemap = newImagemap;
@@ -262,8 +286,8 @@ void Asset::Load(size_t id) {
                         for(auto& filename: filenames) {
                           if(EndsWith(filename, "Skinset.json")) {
                             IncLoading();
-                            GetContent(filename, {{"_parentURI", parentURI}}, [=](Content* content) {
-                              if(content->IsInstance<SkinsetContent>()) {
+                            GetContent(filename, {{"_parentURI", parentURI}, {"_priority", priority}}, cancel, [=](Content* content) {
+                              if(content && !cancel.IsCancelled() && content->IsInstance<SkinsetContent>()) {
                                 refptr newSkinset = new Skinset();
                                 newSkinset->SetContent(content);
                                 newSkeleton->SetSkinset(newSkinset);
@@ -297,7 +321,12 @@ void Asset::Load(size_t id) {
                 uri = loadURL;
                 format = loadFormat;
                 IncLoading();
-                GetContent(loadURL, loadInfo, [=](Content* content) {
+                GetContent(loadURL, loadInfo + json({{"_priority", priority}}), cancel, [=](Content* content) {
+                  if(!content || cancel.IsCancelled()) {
+                    DecLoading();
+                    return;
+                  }
+
                   if(content->IsInstance<ModelContent>()) {
                     refptr newModel = new Model();
                     model = newModel;
@@ -328,10 +357,9 @@ void Asset::Load(size_t id) {
                             std::string name = itName.GetString();
                             if(auto itURL = item.find("url")) {
                               IncLoading();
-                              SendURL(itURL.GetString(), [=](const json& response) {
-                                if(auto it = response.find("data")) {
-                                  std::string data = it.GetString();
-                                  modelTex->AddTexData(name, data, itemCopy);
+                              SendURL(itURL.GetString(), params, cancel, [=](const json& response, const DataBuffer& data) {
+                                if(data && !cancel.IsCancelled()) {
+                                  modelTex->AddTexData(name, *data, itemCopy);
                                 }
 
                                 DecLoading();
@@ -379,6 +407,14 @@ void Asset::Load(size_t id) {
   });
 }
 
+void Asset::CancelLoad() {
+  loadCancel.Cancel();
+
+  for(auto asset: dataManifestAssets) {
+    asset->CancelLoad();
+  }
+}
+
 size_t Asset::GetActionCount() const {
   if(skeleton) {
     if(skeleton->HasContent()) {
@@ -28,6 +28,14 @@ SOFTWARE.
 
 using namespace Prime;
 
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+extern void OnContentReleased(Content* content);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Classes
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,3 +59,20 @@ bool Content::Load(const void* data, size_t dataSize, const json& info) {
 void Content::GetWalkReferences(Stack<std::string>& paths) const {
 
 }
+
+size_t Content::GetCPUSize() const {
+  return 0;
+}
+
+size_t Content::GetGPUSize() const {
+  return 0;
+}
+
+void Content::DecRef() {
+  // Down to the content cache's own reference, so it can be released.
+  if(GetRefCount() == 2) {
+    OnContentReleased(this);
+  }
+
+  RefObject::DecRef();
+}
@@ -174,7 +174,27 @@ void ContentNode::OnActivated(refptr<RefObject> object, refptr<ContentNodeInitPa
 }
 
 void ContentNode::GetWalkReferences(Stack<std::string>& paths) const {
+  if(children) {
+    for(auto node: *children) {
+      if(node) {
+        node->GetWalkReferences(paths);
+      }
+    }
+  }
+}
+
+size_t ContentNode::GetCPUSize() const {
+  size_t size = sizeof(ContentNode) + content.capacity() + name.capacity();
+
+  if(children) {
+    for(auto node: *children) {
+      if(node) {
+        size += node->GetCPUSize();
+      }
+    }
+  }
 
+  return size;
 }
 
 void ContentNode::OnRigSetContent(refptr<ContentNodeInitParam> param) {
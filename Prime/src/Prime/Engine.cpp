@@ -69,6 +69,7 @@ Engine& Engine::GetInstance() {
 }
 
 Engine::Engine():
+jobTimeBudget(0.004),
 currentFrame(0),
 running(false) {
   initialized = true;
@@ -121,7 +122,7 @@ f32 Engine::StartFrame() {
   f32 dt = (f32) (frameTime - lastFrameTime);
   lastFrameTime = frameTime;
 
-  ogalib::Process();
+  ogalib::Process(jobTimeBudget);
 
   PxGraphics.StartFrame();
   PxKeyboard.StartFrame();
@@ -150,6 +151,6 @@ void Engine::ProcessJobs() {
 void Engine::WaitForNoJobs() {
   while(ogalib::Job::HasJobs()) {
     ogalib::Process();
-    Thread::Yield();
+    ogalib::Job::WaitForResponses();
   }
 }
@@ -571,49 +571,52 @@ bool FontContent::Load(const void* data, size_t dataSize, const json& info) {
   }
   else {
     size_t count = newSheet->charInfo.GetCount();
-    for(size_t i = 0; i < count; i++) {
-      texture_glyph_t* glyph = glyphs[i];
-      FontCharInfo& fontCharInfo = newSheet->charInfo[i];
-
-      s32 glyphX = fontCharInfo.tx;
-      s32 glyphY = fontCharInfo.ty;
-      s32 glyphW = fontCharInfo.tw;
-      s32 glyphH = fontCharInfo.th;
-      f32 gradientStart = 1.0f - (glyph->offset_y - adjustY) / baseLineH;
-      f32 gradientRate = 1.0f / baseLineH;
-
-      PrimeAssert(glyphX + glyphW <= (s32) maxTexW, "Glyph is out of texture range.");
-      PrimeAssert(glyphY + glyphH <= (s32) usedTexH, "Glyph is out of texture range.");
-
-      if(useTexFormat == TexFormatR4G4B4A4) {
-        if(use32To16) {
-          // Perform the blending in 32-bit, and then convert to 16-bit on the final composite texture.
-          PrimeAssert(pixelSize == 4, "Expected pixel size to be 4.");
-          PrimeAssert(atlas->dataOutline, "Feature is meant for fonts with outlines.");
-          CopyGlyph32(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
-          BlendGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+    // Glyphs occupy separate regions of the atlas, so they can be copied in parallel.
+    Job::ParallelFor(0, count, [&](size_t begin, size_t end) {
+      for(size_t i = begin; i < end; i++) {
+        texture_glyph_t* glyph = glyphs[i];
+        FontCharInfo& fontCharInfo = newSheet->charInfo[i];
+
+        s32 glyphX = fontCharInfo.tx;
+        s32 glyphY = fontCharInfo.ty;
+        s32 glyphW = fontCharInfo.tw;
+        s32 glyphH = fontCharInfo.th;
+        f32 gradientStart = 1.0f - (glyph->offset_y - adjustY) / baseLineH;
+        f32 gradientRate = 1.0f / baseLineH;
+
+        PrimeAssert(glyphX + glyphW <= (s32) maxTexW, "Glyph is out of texture range.");
+        PrimeAssert(glyphY + glyphH <= (s32) usedTexH, "Glyph is out of texture range.");
+
+        if(useTexFormat == TexFormatR4G4B4A4) {
+          if(use32To16) {
+            // Perform the blending in 32-bit, and then convert to 16-bit on the final composite texture.
+            PrimeAssert(pixelSize == 4, "Expected pixel size to be 4.");
+            PrimeAssert(atlas->dataOutline, "Feature is meant for fonts with outlines.");
+            CopyGlyph32(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
+            BlendGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+          }
+          else {
+            u16* pixels16 = (u16*) pixels;
+            if(atlas->dataOutline) {
+              CopyGlyph16(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
+              BlendGlyph16(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+            }
+            else {
+              CopyGlyph16(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+            }
+          }
         }
         else {
-          u16* pixels16 = (u16*) pixels;
           if(atlas->dataOutline) {
-            CopyGlyph16(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
-            BlendGlyph16(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+            CopyGlyph32(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
+            BlendGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
           }
           else {
-            CopyGlyph16(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u16), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
+            CopyGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
           }
         }
       }
-      else {
-        if(atlas->dataOutline) {
-          CopyGlyph32(atlas->dataOutline, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorOutlineR, nsv.colorOutlineG, nsv.colorOutlineB, nsv.colorOutlineA, nsv.colorOutline2R, nsv.colorOutline2G, nsv.colorOutline2B, nsv.colorOutline2A, nsv.colorOutline3R, nsv.colorOutline3G, nsv.colorOutline3B, nsv.colorOutline3A, nsv.gradientOutline, nsv.gradientOutlineTop, nsv.gradientOutlineBottom, gradientStart, gradientRate);
-          BlendGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
-        }
-        else {
-          CopyGlyph32(atlas->data, glyphX, glyphY, glyphW, glyphH, maxTexW, pixels, maxTexW * sizeof(u32), nsv.colorR, nsv.colorG, nsv.colorB, nsv.colorA, nsv.color2R, nsv.color2G, nsv.color2B, nsv.color2A, nsv.color3R, nsv.color3G, nsv.color3B, nsv.color3A, nsv.gradient, nsv.gradientTop, nsv.gradientBottom, gradientStart, gradientRate);
-        }
-      }
-    }
+    }, 16);
 
     if(useTexFormat == TexFormatR4G4B4A4) {
       if(use32To16) {
@@ -746,6 +749,24 @@ void FontContent::CheckReload() {
   mutex->Unlock();
 }
 
+size_t FontContent::GetCPUSize() const {
+  size_t size = Content::GetCPUSize() + fontData.capacity();
+
+  if(sheet && sheet->tex)
+    size += sheet->tex->GetCPUSize();
+
+  return size;
+}
+
+size_t FontContent::GetGPUSize() const {
+  size_t size = Content::GetGPUSize();
+
+  if(sheet && sheet->tex)
+    size += sheet->tex->GetGPUSize();
+
+  return size;
+}
+
 void FontContent::GetDefaultValues(json& values) {
   values["h"] = 20.0f;
   values["outline"] = 0.0f;
@@ -112,3 +112,11 @@ void ArrayBuffer::SetSyncCount(size_t count) {
 void ArrayBuffer::Sync() {
   PrimeAssert(false, "Unimplemented sync function for ArrayBuffer.");
 }
+
+size_t ArrayBuffer::GetCPUSize() const {
+  return itemSize * itemCount;
+}
+
+size_t ArrayBuffer::GetGPUSize() const {
+  return loadedIntoVRAM ? itemSize * itemCount : 0;
+}
@@ -83,3 +83,11 @@ void IndexBuffer::SetSyncCount(size_t count) {
 void IndexBuffer::Sync() {
   PrimeAssert(false, "Unimplemented sync function for IndexBuffer.");
 }
+
+size_t IndexBuffer::GetCPUSize() const {
+  return format != IndexFormatNone ? GetIndexSize() * indexCount : 0;
+}
+
+size_t IndexBuffer::GetGPUSize() const {
+  return loadedIntoVRAM ? GetCPUSize() : 0;
+}
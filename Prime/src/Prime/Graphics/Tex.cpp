@@ -52,9 +52,9 @@ typedef struct _PNGDataRead {
 struct jpegErrorManager {
   struct jpeg_error_mgr pub;
   jmp_buf setjmp_buffer;
+  char lastErrorMsg[JMSG_LENGTH_MAX];
 };
 
-static char jpegLastErrorMsg[JMSG_LENGTH_MAX];
 static void jpegErrorExit(j_common_ptr cinfo);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -383,7 +383,7 @@ void Tex::AddTexData(const std::string& name, const std::string& data, const jso
                   texData->tw = texData->w;
                   texData->th = texData->h;
 
-                  job.data["texData"] = texData;
+                  job.SetResult(texData);
                 }
               }
             }
@@ -496,7 +496,7 @@ void Tex::AddTexData(const std::string& name, const std::string& data, const jso
                   texData->tw = texData->w;
                   texData->th = texData->h;
 
-                  job.data["texData"] = texData;
+                  job.SetResult(texData);
                 }
               }
             }
@@ -508,19 +508,19 @@ void Tex::AddTexData(const std::string& name, const std::string& data, const jso
       if(IsFormatPNG(data.c_str(), data.size(), info)) {
         TexData* texData = new TexData();
         if(texData && LoadPixelsFromPNG(data.c_str(), data.size(), *texData)) {
-          job.data["texData"] = texData;
+          job.SetResult(texData);
         }
       }
       else if(IsFormatJPEG(data.c_str(), data.size(), info)) {
         TexData* texData = new TexData();
         if(texData && LoadPixelsFromJPEG(data.c_str(), data.size(), *texData)) {
-          job.data["texData"] = texData;
+          job.SetResult(texData);
         }
       }
     }
   }, [=](Job& job) {
-    if(auto it = job.data.find("texData")) {
-      TexData* tempTexData = it.GetPtr<TexData>();
+    if(job.HasResult()) {
+      TexData* tempTexData = job.GetResult<TexData*>();
       if(tempTexData) {
         TexData* texData;
         
@@ -1139,6 +1139,24 @@ bool Tex::HasA() const {
   return hasA;
 }
 
+size_t Tex::GetCPUSize() const {
+  size_t size = 0;
+
+  for(auto it: texDataLookup) {
+    TexData* texData = it.value();
+    if(texData && texData->pixels) {
+      size += texData->pixels->GetSize();
+    }
+  }
+
+  return size;
+}
+
+size_t Tex::GetGPUSize() const {
+  // Every level with pixels is uploaded as is.
+  return loadedIntoVRAM ? GetCPUSize() : 0;
+}
+
 bool Tex::LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData) {
   png_structp png;
   png_infop pngInfo;
@@ -1180,6 +1198,18 @@ bool Tex::LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData)
   png_set_read_fn(png, &dr, ReadPNGData);
   png_set_sig_bytes(png, 8);
   png_set_option(png, PNG_SKIP_sRGB_CHECK_PROFILE, PNG_OPTION_OFF);
+
+  png_bytep* volatile rows = nullptr;
+
+  // The jmpbuf lives in this decode's png struct, so decodes can run in parallel.
+  if(setjmp(png_jmpbuf(png))) {
+    texData = 0;
+    png_destroy_read_struct(&png, &pngInfo, nullptr);
+    free(rows);
+    dbgprintf("[Warning] Error decoding PNG data.");
+    return false;
+  }
+
   png_read_info(png, pngInfo);
 
   texData.w = pngInfo->width;
@@ -1252,7 +1282,7 @@ bool Tex::LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData)
   int passCount = png_set_interlace_handling(png);
   png_read_update_info(png, pngInfo);
 
-  png_bytep* rows = (png_bytep*) malloc(sizeof(png_bytep) * texData.h);
+  rows = (png_bytep*) malloc(sizeof(png_bytep) * texData.h);
   if(!rows) {
     texData = 0;
     png_destroy_read_struct(&png, &pngInfo, nullptr);
@@ -1268,6 +1298,7 @@ bool Tex::LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData)
     else {
       texData = 0;
       png_destroy_read_struct(&png, &pngInfo, nullptr);
+      free(rows);
       dbgprintf("[Warning] Could not locate pixel destination for row %d.", y);
       return false;
     }
@@ -1281,8 +1312,6 @@ bool Tex::LoadPixelsFromPNG(const void* data, size_t dataSize, TexData& texData)
 }
 
 bool Tex::LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData) {
-  LockSetjmpMutex();
-
   struct jpeg_decompress_struct jpegInfo;
   jpegErrorManager jerr;
 
@@ -1291,11 +1320,14 @@ bool Tex::LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData
 
   jpeg_create_decompress(&jpegInfo);
 
+  u8** volatile rows = nullptr;
+
+  // The error manager and its message buffer are per decode, so decodes can run in parallel.
   if(setjmp(jerr.setjmp_buffer)) {
-    // If we get here, the JPEG code has signaled an error.
     texData = 0;
     jpeg_destroy_decompress(&jpegInfo);
-    UnlockSetjmpMutex();
+    free(rows);
+    dbgprintf("[Warning] Error decoding JPEG data: %s", jerr.lastErrorMsg);
     return false;
   }
 
@@ -1309,7 +1341,6 @@ bool Tex::LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData
   if(texData.w == 0 || texData.h == 0) {
     texData = 0;
     jpeg_destroy_decompress(&jpegInfo);
-    UnlockSetjmpMutex();
     return false;
   }
 
@@ -1368,7 +1399,6 @@ bool Tex::LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData
     texData = 0;
     jpeg_destroy_decompress(&jpegInfo);
     dbgprintf("[Warning] Unsupported pixel size for texture format.");
-    UnlockSetjmpMutex();
     return false;
   }
 
@@ -1381,17 +1411,36 @@ bool Tex::LoadPixelsFromJPEG(const void* data, size_t dataSize, TexData& texData
   size_t pixelsSize = texData.th * dataStride;
   texData.pixels = new BlockBuffer(dataStride, pixelsSize);
 
-  while(jpegInfo.output_scanline < jpegInfo.output_height) {
-    void* row = texData.pixels->GetAddr(jpegInfo.output_scanline * dataStride);
-    if(row) {
-      u8* rows[1] = {(u8*) row};
-      jpeg_read_scanlines(&jpegInfo, rows, 1);
+  rows = (u8**) malloc(sizeof(u8*) * texData.h);
+  if(!rows) {
+    texData = 0;
+    jpeg_destroy_decompress(&jpegInfo);
+    dbgprintf("Error reading JPEG data.\n");
+    return false;
+  }
+
+  for(u32 y = 0; y < texData.h; y++) {
+    void* addr = texData.pixels->GetAddr(dataStride * y);
+    if(addr) {
+      rows[y] = (u8*) addr;
+    }
+    else {
+      texData = 0;
+      jpeg_destroy_decompress(&jpegInfo);
+      free(rows);
+      dbgprintf("[Warning] Could not locate pixel destination for row %d.", y);
+      return false;
     }
   }
 
-  jpeg_destroy_decompress(&jpegInfo);
+  while(jpegInfo.output_scanline < jpegInfo.output_height) {
+    u32 y = jpegInfo.output_scanline;
+    if(jpeg_read_scanlines(&jpegInfo, rows + y, jpegInfo.output_height - y) == 0)
+      break;
+  }
 
-  UnlockSetjmpMutex();
+  jpeg_destroy_decompress(&jpegInfo);
+  free(rows);
 
   return true;
 }
@@ -1528,6 +1577,6 @@ void ReadPNGData(png_structp png, png_bytep data, png_size_t size) {
 
 static void jpegErrorExit(j_common_ptr cinfo) {
   jpegErrorManager* myerr = (jpegErrorManager*) cinfo->err;
-  (*(cinfo->err->format_message)) (cinfo, jpegLastErrorMsg);
+  (*(cinfo->err->format_message)) (cinfo, myerr->lastErrorMsg);
   longjmp(myerr->setjmp_buffer, 1);
 }
@@ -462,7 +462,6 @@ bool ImagemapContent::LoadFromPNG(const void* data, size_t dataSize, const json&
   if(!Tex::LoadPixelsFromPNG(data, dataSize, texData))
     return false;
 
-  std::string dataCopy((const char*) data, dataSize);
   u32 w = texData.w;
   u32 h = texData.h;
 
@@ -516,7 +515,6 @@ bool ImagemapContent::LoadFromJPEG(const void* data, size_t dataSize, const json
   if(!Tex::LoadPixelsFromJPEG(data, dataSize, texData))
     return false;
 
-  std::string dataCopy((const char*) data, dataSize);
   u32 w = texData.w;
   u32 h = texData.h;
 
@@ -700,6 +698,41 @@ void ImagemapContent::Draw(size_t index) {
   }
 }
 
+size_t ImagemapContent::GetCPUSize() const {
+  size_t size = Content::GetCPUSize();
+
+  if(rects) {
+    for(size_t i = 0; i < rectCount; i++) {
+      size += sizeof(ImagemapContentRect) + sizeof(ImagemapContentRectPoint) * rects[i].pointCount;
+    }
+  }
+
+  if(texRects)
+    size += sizeof(ImagemapContentTexRect) * rectCount;
+
+  if(tex)
+    size += tex->GetCPUSize();
+  if(ab)
+    size += ab->GetCPUSize();
+  if(ib)
+    size += ib->GetCPUSize();
+
+  return size;
+}
+
+size_t ImagemapContent::GetGPUSize() const {
+  size_t size = Content::GetGPUSize();
+
+  if(tex)
+    size += tex->GetGPUSize();
+  if(ab)
+    size += ab->GetGPUSize();
+  if(ib)
+    size += ib->GetGPUSize();
+
+  return size;
+}
+
 void ImagemapContent::CreateBuffers() {
   static const std::string originStr("origin");
 
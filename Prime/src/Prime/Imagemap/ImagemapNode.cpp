@@ -107,3 +107,11 @@ void ImagemapNode::OnActivated(refptr<RefObject> object, refptr<ContentNodeInitP
     });
   }
 }
+
+void ImagemapNode::GetWalkReferences(Stack<std::string>& paths) const {
+  ContentNode::GetWalkReferences(paths);
+
+  if(!content.empty()) {
+    paths.Add(content);
+  }
+}
@@ -255,3 +255,23 @@ void ModelContent::ApplyTextureToMesh(ModelContentMesh& mesh) {
     }
   }
 }
+
+size_t ModelContent::GetCPUSize() const {
+  size_t size = Content::GetCPUSize();
+
+  for(size_t i = 0; i < sceneCount; i++) {
+    size += scenes[i].GetCPUSize();
+  }
+
+  return size;
+}
+
+size_t ModelContent::GetGPUSize() const {
+  size_t size = Content::GetGPUSize();
+
+  for(size_t i = 0; i < sceneCount; i++) {
+    size += scenes[i].GetGPUSize();
+  }
+
+  return size;
+}
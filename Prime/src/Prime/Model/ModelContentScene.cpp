@@ -118,6 +118,55 @@ size_t ModelContentScene::GetMeshIndexByName(const std::string& name) const {
   return PrimeNotFound;
 }
 
+size_t ModelContentScene::GetCPUSize() const {
+  size_t size = 0;
+
+  for(size_t i = 0; i < meshCount; i++) {
+    const ModelContentMesh& mesh = meshes[i];
+
+    // Meshes keep their vertices and indices alongside the buffers built from them.
+    if(mesh.vertices)
+      size += mesh.vertexCount * (mesh.anim ? sizeof(ModelMeshAnimVertex) : sizeof(ModelMeshVertex));
+    if(mesh.indices && mesh.ib)
+      size += mesh.indexCount * mesh.ib->GetIndexSize();
+
+    if(mesh.ab)
+      size += mesh.ab->GetCPUSize();
+    if(mesh.ib)
+      size += mesh.ib->GetCPUSize();
+  }
+
+  // Only textures embedded in the model. Referenced imagemaps are cached on their own and the default tex is shared.
+  for(auto& tex: textures) {
+    if(tex && tex != ModelContent::defaultTex) {
+      size += tex->GetCPUSize();
+    }
+  }
+
+  return size;
+}
+
+size_t ModelContentScene::GetGPUSize() const {
+  size_t size = 0;
+
+  for(size_t i = 0; i < meshCount; i++) {
+    const ModelContentMesh& mesh = meshes[i];
+
+    if(mesh.ab)
+      size += mesh.ab->GetGPUSize();
+    if(mesh.ib)
+      size += mesh.ib->GetGPUSize();
+  }
+
+  for(auto& tex: textures) {
+    if(tex && tex != ModelContent::defaultTex) {
+      size += tex->GetGPUSize();
+    }
+  }
+
+  return size;
+}
+
 void ModelContentScene::DestroyMeshes() {
   if(meshCount > 0) {
     for(size_t i = 0; i < meshCount; i++) {
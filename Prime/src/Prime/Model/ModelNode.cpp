@@ -71,3 +71,11 @@ void ModelNode::OnActivated(refptr<RefObject> object, refptr<ContentNodeInitPara
     });
   }
 }
+
+void ModelNode::GetWalkReferences(Stack<std::string>& paths) const {
+  ContentNode::GetWalkReferences(paths);
+
+  if(!content.empty()) {
+    paths.Add(content);
+  }
+}
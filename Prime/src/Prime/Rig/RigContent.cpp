@@ -126,3 +126,29 @@ bool RigContent::Load(const json& data, const json& info) {
 
   return true;
 }
+
+void RigContent::GetWalkReferences(Stack<std::string>& paths) const {
+  Content::GetWalkReferences(paths);
+
+  if(children) {
+    for(auto node: *children) {
+      if(node) {
+        node->GetWalkReferences(paths);
+      }
+    }
+  }
+}
+
+size_t RigContent::GetCPUSize() const {
+  size_t size = Content::GetCPUSize();
+
+  if(children) {
+    for(auto node: *children) {
+      if(node) {
+        size += node->GetCPUSize();
+      }
+    }
+  }
+
+  return size;
+}
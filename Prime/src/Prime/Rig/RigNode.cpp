@@ -71,3 +71,11 @@ void RigNode::OnActivated(refptr<RefObject> object, refptr<ContentNodeInitParam>
     });
   }
 }
+
+void RigNode::GetWalkReferences(Stack<std::string>& paths) const {
+  ContentNode::GetWalkReferences(paths);
+
+  if(!content.empty()) {
+    paths.Add(content);
+  }
+}
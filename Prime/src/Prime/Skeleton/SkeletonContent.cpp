@@ -664,6 +664,50 @@ bool SkeletonContent::Load(const json& data, const json& info) {
   return true;
 }
 
+void SkeletonContent::GetWalkReferences(Stack<std::string>& paths) const {
+  Content::GetWalkReferences(paths);
+
+  if(!skinset.empty()) {
+    paths.Add(skinset);
+  }
+}
+
+size_t SkeletonContent::GetCPUSize() const {
+  size_t size = Content::GetCPUSize();
+
+  size += sizeof(SkeletonContentBone) * boneCount;
+
+  if(orderedBoneHierarchy)
+    size += sizeof(size_t) * boneCount;
+  if(orderedBoneHierarchyRev)
+    size += sizeof(size_t) * boneCount;
+
+  // Pose bone counts are not kept, so each pose is charged for every bone.
+  for(size_t i = 0; i < poseCount; i++) {
+    const SkeletonContentPose& pose = poses[i];
+
+    size += sizeof(SkeletonContentPose);
+
+    if(pose.bones)
+      size += sizeof(SkeletonContentPoseBone) * boneCount;
+    if(pose.boneTransforms)
+      size += sizeof(SkeletonContentPoseBoneTransform) * boneCount;
+  }
+
+  for(size_t i = 0; i < actionCount; i++) {
+    const SkeletonContentAction& action = actions[i];
+
+    size += sizeof(SkeletonContentAction);
+
+    for(size_t j = 0; j < action.keyFrameCount; j++) {
+      size += sizeof(SkeletonContentActionKeyFrame);
+      size += sizeof(SkeletonContentActionKeyFramePieceActionMapping) * action.keyFrames[j].pieceActionMappingCount;
+    }
+  }
+
+  return size;
+}
+
 const SkeletonContentBone* SkeletonContent::FindBone(const std::string& name) const {
   for(size_t i = 0; i < boneCount; i++) {
     if(name == bones[i].name) {
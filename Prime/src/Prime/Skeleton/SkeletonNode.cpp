@@ -92,3 +92,14 @@ void SkeletonNode::OnActivated(refptr<RefObject> object, refptr<ContentNodeInitP
     });
   }
 }
+
+void SkeletonNode::GetWalkReferences(Stack<std::string>& paths) const {
+  ContentNode::GetWalkReferences(paths);
+
+  if(!content.empty()) {
+    paths.Add(content);
+  }
+  if(!skinset.empty()) {
+    paths.Add(skinset);
+  }
+}
@@ -175,6 +175,10 @@ void SkinsetContent::GetWalkReferences(Stack<std::string>& paths) const {
   }
 }
 
+size_t SkinsetContent::GetCPUSize() const {
+  return Content::GetCPUSize() + sizeof(SkinsetContentPiece) * pieceCount;
+}
+
 SkinsetContentAffixPieceLookupStack* SkinsetContent::CreateAffixPieceLookupStack(const std::string& affix) {
   SkinsetContentAffixPieceLookupStack* result = new SkinsetContentAffixPieceLookupStack();
 
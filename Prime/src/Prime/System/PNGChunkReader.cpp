@@ -0,0 +1,157 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Prime/System/PNGChunkReader.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <zlib/zlib.h>
+
+using namespace Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants
+////////////////////////////////////////////////////////////////////////////////
+
+static const uint8_t PNGSignature[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t ReadPNGU32(const uint8_t* p) {
+  return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+PNGChunkReader::PNGChunkReader(const void* data, size_t dataSize, bool verifyCRC):
+data((const uint8_t*) data),
+dataSize(dataSize),
+pos(sizeof(PNGSignature)),
+verifyCRC(verifyCRC),
+valid(IsPNG(data, dataSize)),
+done(false) {
+  memset(&chunk, 0, sizeof(chunk));
+}
+
+PNGChunkReader::~PNGChunkReader() {
+
+}
+
+bool PNGChunkReader::Next() {
+  return Advance(verifyCRC);
+}
+
+bool PNGChunkReader::Find(const char* type) {
+  // Only the matching chunk's CRC is checked, so skipping past IDAT costs nothing.
+  while(Advance(false)) {
+    if(memcmp(chunk.type, type, 4) == 0) {
+      if(!verifyCRC || IsChunkCRCValid())
+        return true;
+
+      if(!IsChunkAncillary()) {
+        valid = false;
+        break;
+      }
+    }
+  }
+
+  memset(&chunk, 0, sizeof(chunk));
+  return false;
+}
+
+bool PNGChunkReader::Advance(bool checkCRC) {
+  while(valid && !done) {
+    // Each chunk is a 4 byte length, 4 byte type, the data and a 4 byte CRC.
+    if(dataSize - pos < 12) {
+      valid = false;
+      break;
+    }
+
+    const uint8_t* p = &data[pos];
+    uint32_t size = ReadPNGU32(p);
+    if(size > 0x7FFFFFFF || dataSize - pos - 12 < size) {
+      valid = false;
+      break;
+    }
+
+    pos += 12 + (size_t) size;
+
+    memcpy(chunk.type, p + 4, 4);
+    chunk.type[4] = '\0';
+    chunk.data = p + 8;
+    chunk.size = size;
+
+    if(checkCRC && !IsChunkCRCValid()) {
+      // Matches libpng's default of discarding ancillary chunks with a bad CRC.
+      if(!IsChunkAncillary()) {
+        valid = false;
+        break;
+      }
+
+      continue;
+    }
+
+    if(memcmp(chunk.type, "IEND", 4) == 0)
+      done = true;
+
+    return true;
+  }
+
+  memset(&chunk, 0, sizeof(chunk));
+  return false;
+}
+
+bool PNGChunkReader::IsChunkAncillary() const {
+  return (chunk.type[0] & 0x20) != 0;
+}
+
+bool PNGChunkReader::IsChunkCRCValid() const {
+  const uint8_t* p = (const uint8_t*) chunk.data - 4;
+  uint32_t crc = (uint32_t) crc32(0, p, 4 + chunk.size);
+  return crc == ReadPNGU32(p + 4 + chunk.size);
+}
+
+bool PNGChunkReader::IsPNG(const void* data, size_t dataSize) {
+  return data && dataSize >= sizeof(PNGSignature) && memcmp(data, PNGSignature, sizeof(PNGSignature)) == 0;
+}
+
+bool PNGChunkReader::FindChunk(const void* data, size_t dataSize, const char* type, PNGChunk& chunk) {
+  PNGChunkReader reader(data, dataSize);
+  if(reader.Find(type)) {
+    chunk = reader.GetChunk();
+    return true;
+  }
+
+  memset(&chunk, 0, sizeof(chunk));
+  return false;
+}
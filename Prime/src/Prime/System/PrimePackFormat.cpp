@@ -30,9 +30,10 @@ SOFTWARE.
 // Includes
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <png/png.h>
-#include <png/pngstruct.h>
-#include <png/pnginfo.h>
+#include <Prime/Config.h>
+#include <Prime/System/PNGChunkReader.h>
+#include <atomic>
+#include <string.h>
 #include <zlib/zlib.h>
 
 using namespace Prime;
@@ -42,7 +43,6 @@ using namespace Prime;
 ////////////////////////////////////////////////////////////////////////////////
 
 #define PPFBlockBufferBlockSize (512 * 1024)
-#define PPFBlockBufferReadSize (2 * 1024 * 1024)
 
 ////////////////////////////////////////////////////////////////////////////////
 // Constants
@@ -56,38 +56,70 @@ static const std::unordered_map<std::string, std::string> PrimePackFormatEmptyMe
 // Functions
 ////////////////////////////////////////////////////////////////////////////////
 
-static void ReadPNGFromFile(png_structp png, png_bytep data, png_size_t size);
-static int ReadPNGChunk(png_structp png, png_unknown_chunkp chunk);
+static bool IsRangeValid(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t dataSize) {
+  if(offset > dataSize)
+    return false;
+
+  if(elementSize > 0 && count > (dataSize - offset) / elementSize)
+    return false;
+
+  return true;
+}
+
+static bool InflateData(const void* src, size_t srcSize, void* p, size_t size) {
+  if(srcSize > UINT32_MAX || size > UINT32_MAX)
+    return false;
+
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+
+  if(inflateInit(&stream) != Z_OK)
+    return false;
+
+  stream.next_in = (Bytef*) src;
+  stream.avail_in = (uInt) srcSize;
+  stream.next_out = (Bytef*) p;
+  stream.avail_out = (uInt) size;
+
+  // The output size is known up front, so inflate lands directly in the result.
+  int inflateResult = inflate(&stream, Z_FINISH);
+  bool success = inflateResult == Z_STREAM_END && stream.avail_out == 0;
+
+  inflateEnd(&stream);
+
+  return success;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // Classes
 ////////////////////////////////////////////////////////////////////////////////
 
 PrimePackFormat::PrimePackFormat():
-ppfData(nullptr),
-loadChunk(nullptr),
-loadChunkSize(0),
+ppfBytes(nullptr),
+ppfSize(0),
 version(0),
-error(PrimePackFormatErrorNone) {
-
+error(PrimePackFormatErrorNone),
+directoriesValid(false) {
+  memset(&v3Header, 0, sizeof(v3Header));
 }
 
 PrimePackFormat::PrimePackFormat(void* data, size_t dataSize):
-ppfData(nullptr),
-loadChunk(nullptr),
-loadChunkSize(0),
+ppfBytes(nullptr),
+ppfSize(0),
 version(0),
-error(PrimePackFormatErrorNone) {
+error(PrimePackFormatErrorNone),
+directoriesValid(false) {
+  memset(&v3Header, 0, sizeof(v3Header));
   InitFromData(data, dataSize);
 }
 
 PrimePackFormat::PrimePackFormat(PrimePackFormatError error):
-ppfData(nullptr),
-loadChunk(nullptr),
-loadChunkSize(0),
+ppfBytes(nullptr),
+ppfSize(0),
 version(0),
-error(error) {
-
+error(error),
+directoriesValid(false) {
+  memset(&v3Header, 0, sizeof(v3Header));
 }
 
 PrimePackFormat::~PrimePackFormat() {
@@ -104,12 +136,6 @@ PrimePackFormat::~PrimePackFormat() {
       delete item;
     }
   }
-
-  if(loadChunk)
-    free(loadChunk);
-
-  if(ppfData)
-    delete ppfData;
 }
 
 bool PrimePackFormat::HasItem(const std::string& path) const {
@@ -121,29 +147,53 @@ bool PrimePackFormat::HasItem(const std::string& path) const {
     return true;
   }
 
-  return false;
+  PrimePackFormatV3Entry entry;
+  return FindEntry(path, entry);
 }
 
 size_t PrimePackFormat::GetItemCount() const {
-  return items.size() + addedItems.size();
+  return items.size() + addedItems.size() + (size_t) v3Header.itemCount;
 }
 
 void PrimePackFormat::GetItemPaths(std::vector<std::string>& paths) const {
-  for(auto it: addedItems) {
-    const std::string& path = it.first;
-    if(std::find(paths.begin(), paths.end(), path) == paths.end()) {
-      paths.push_back(path);
+  paths.reserve(paths.size() + addedItems.size() + items.size());
+
+  for(const auto& it: addedItems) {
+    paths.push_back(it.first);
+  }
+
+  for(const auto& it: items) {
+    if(addedItems.find(it.first) == addedItems.end()) {
+      paths.push_back(it.first);
     }
   }
 
-  for(auto it: items) {
-    const std::string& path = it.first;
-    if(std::find(paths.begin(), paths.end(), path) == paths.end()) {
-      paths.push_back(path);
+  for(uint64_t i = 0; i < v3Header.itemCount; i++) {
+    PrimePackFormatV3Entry entry;
+    if(ReadEntry(i, entry)) {
+      std::string path = ReadString(entry.pathOffset, entry.pathSize);
+      if(addedItems.find(path) == addedItems.end()) {
+        paths.push_back(path);
+      }
     }
   }
 }
 
+void PrimePackFormat::GetDirectoryPaths(const std::string& directory, std::vector<std::string>& paths) const {
+  if(!directoriesValid) {
+    BuildDirectories();
+  }
+
+  std::string key = directory;
+  if(!key.empty() && key.back() != '/')
+    key += '/';
+
+  auto it = directories.find(key);
+  if(it != directories.end()) {
+    paths.insert(paths.end(), it->second.begin(), it->second.end());
+  }
+}
+
 BlockBuffer* PrimePackFormat::GetItemData(const std::string& path, size_t blockSize) const {
   if(error) {
     return nullptr;
@@ -160,114 +210,185 @@ BlockBuffer* PrimePackFormat::GetItemData(const std::string& path, size_t blockS
     }
   }
 
-  auto itItem = items.find(path);
-  if(itItem == items.end())
+  size_t size = 0;
+  const void* span = GetItemSpan(path, &size);
+  void* bytes = span ? nullptr : GetItemBytes(path, &size);
+  if(!span && !bytes)
     return nullptr;
 
-  PrimePackFormatItem* itemPtr = itItem->second;
-  if(!itemPtr)
+  size_t useBlockSize = blockSize == 0 ? PPFBlockBufferBlockSize : blockSize;
+  if(useBlockSize > size)
+    useBlockSize = size;
+
+  BlockBuffer* blockBuffer = new BlockBuffer(useBlockSize);
+  if(blockBuffer) {
+    blockBuffer->Append(span ? span : bytes, size);
+  }
+
+  if(bytes) {
+    free(bytes);
+  }
+
+  return blockBuffer;
+}
+
+const void* PrimePackFormat::GetItemSpan(const std::string& path, size_t* size) const {
+  if(size) {
+    *size = 0;
+  }
+
+  if(error || addedItems.find(path) != addedItems.end()) {
     return nullptr;
+  }
 
-  PrimePackFormatItem& item = *itemPtr;
-  BlockBuffer* blockBuffer = nullptr;
+  // Only stored items can be handed out in place; compressed ones go through GetItemBytes.
+  PrimePackFormatItemLocation location;
+  if(!FindItem(path, location) || location.compression != PrimePackFormatCompressionNone || location.size == 0)
+    return nullptr;
 
-  if(item.size > 0) {
-    size_t ppfBlockBufferBlockSize = PPFBlockBufferBlockSize;
-    size_t ppfBlockBufferReadSize = PPFBlockBufferReadSize;
+  if(!IsRangeValid(location.offset, location.size, 1, ppfSize))
+    return nullptr;
 
-    size_t useBlockSize = blockSize == 0 ? ppfBlockBufferBlockSize : blockSize;
-    if(useBlockSize > item.size)
-      useBlockSize = item.size;
+  if(size) {
+    *size = (size_t) location.size;
+  }
 
-    blockBuffer = new BlockBuffer(useBlockSize);
-    if(blockBuffer) {
-      size_t readBufferSize = std::min(ppfBlockBufferReadSize, item.size);
-      uint8_t* buffer = (uint8_t*) malloc(readBufferSize);
-      if(buffer) {
-        size_t bytesRemaining = item.size;
-        size_t bytesRead;
-        do {
-          size_t bytesToRead = std::min(readBufferSize, bytesRemaining);
-          bytesRead = ppfData->Read(buffer, item.offset + (item.size - bytesRemaining), bytesToRead);
-          if(bytesRead > 0) {
-            blockBuffer->Append(buffer, bytesRead);
-            bytesRemaining -= bytesRead;
+  return ppfBytes + location.offset;
+}
+
+void* PrimePackFormat::GetItemBytes(const std::string& path, size_t* size) const {
+  if(size) {
+    *size = 0;
+  }
+
+  if(error) {
+    return nullptr;
+  }
+
+  auto itAddedItem = addedItems.find(path);
+  if(itAddedItem != addedItems.end()) {
+    BlockBuffer* blockBuffer = itAddedItem->second;
+    return blockBuffer ? blockBuffer->ConvertToBytes(size) : nullptr;
+  }
+
+  PrimePackFormatItemLocation location;
+  if(!FindItem(path, location) || location.size == 0 || location.size > SIZE_MAX)
+    return nullptr;
+
+  void* bytes = malloc((size_t) location.size);
+  if(!bytes)
+    return nullptr;
+
+  if(ReadItem(path, 0, bytes, (size_t) location.size) != location.size) {
+    free(bytes);
+    return nullptr;
+  }
+
+  if(size) {
+    *size = (size_t) location.size;
+  }
+
+  return bytes;
+}
+
+size_t PrimePackFormat::ReadItem(const std::string& path, uint64_t offset, void* p, size_t size) const {
+  if(error || p == nullptr || size == 0) {
+    return 0;
+  }
+
+  auto itAddedItem = addedItems.find(path);
+  if(itAddedItem != addedItems.end()) {
+    BlockBuffer* blockBuffer = itAddedItem->second;
+    if(!blockBuffer || offset >= blockBuffer->GetSize())
+      return 0;
+
+    return blockBuffer->Read(p, (size_t) offset, size);
+  }
+
+  PrimePackFormatItemLocation location;
+  if(!FindItem(path, location) || offset >= location.size)
+    return 0;
+
+  if(size > location.size - offset)
+    size = (size_t) (location.size - offset);
+
+  if(location.compression == PrimePackFormatCompressionNone) {
+    if(!IsRangeValid(location.offset, location.size, 1, ppfSize))
+      return 0;
+
+    memcpy(p, ppfBytes + location.offset + offset, size);
+    return size;
+  }
+  else if(location.compression == PrimePackFormatCompressionZlib) {
+    if(location.offset > ppfSize)
+      return 0;
+
+    size_t srcSize = ppfSize - (size_t) location.offset;
+    if(location.dataSize > 0 && location.dataSize < srcSize)
+      srcSize = (size_t) location.dataSize;
+
+    const uint8_t* src = ppfBytes + location.offset;
+
+    if(offset == 0 && size == location.size) {
+      return InflateData(src, srcSize, p, size) ? size : 0;
+    }
+
+    // A single stream can only be decoded from the start.
+    void* bytes = malloc((size_t) location.size);
+    if(!bytes)
+      return 0;
+
+    bool success = InflateData(src, srcSize, bytes, (size_t) location.size);
+    if(success) {
+      memcpy(p, (const uint8_t*) bytes + offset, size);
+    }
+
+    free(bytes);
+    return success ? size : 0;
+  }
+  else if(location.compression == PrimePackFormatCompressionZlibBlocks) {
+    if(location.blockSize == 0)
+      return 0;
+
+    uint64_t blockSize = location.blockSize;
+    uint64_t firstBlock = offset / blockSize;
+    uint64_t lastBlock = (offset + size - 1) / blockSize;
+    std::atomic<bool> success(true);
+
+    // Blocks are independent streams, so they inflate in parallel and only the requested range is touched.
+    Job::ParallelFor((size_t) firstBlock, (size_t) lastBlock + 1, [&](size_t begin, size_t end) {
+      for(size_t block = begin; block < end && success; block++) {
+        uint64_t blockStart = block * blockSize;
+        uint64_t blockEnd = std::min(blockStart + blockSize, location.size);
+        uint64_t copyStart = std::max(blockStart, offset);
+        uint64_t copyEnd = std::min(blockEnd, offset + size);
+        uint8_t* dest = (uint8_t*) p + (copyStart - offset);
+
+        if(copyStart == blockStart && copyEnd == blockEnd) {
+          if(!InflateBlock(location, block, dest)) {
+            success = false;
+          }
+        }
+        else {
+          uint8_t* blockBytes = (uint8_t*) malloc((size_t) (blockEnd - blockStart));
+          if(blockBytes && InflateBlock(location, block, blockBytes)) {
+            memcpy(dest, blockBytes + (copyStart - blockStart), (size_t) (copyEnd - copyStart));
           }
           else {
-            break;
+            success = false;
           }
-        }
-        while(bytesRemaining > 0);
-        free(buffer);
-      }
-      else {
-        if(blockBuffer) {
-          delete blockBuffer;
-        }
-      }
 
-      if(blockBuffer) {
-        if(item.compression == 1) {
-          BlockBuffer* uncompressedBlockBuffer = new BlockBuffer(useBlockSize);
-          void* bufferIn = malloc(ppfBlockBufferReadSize);
-          void* bufferOut = malloc(ppfBlockBufferReadSize);
-
-          z_stream stream;
-          stream.zalloc = Z_NULL;
-          stream.zfree = Z_NULL;
-          stream.opaque = Z_NULL;
-
-          inflateInit(&stream);
-
-          size_t bytesRead = 0;
-          size_t bytesUncompressed = 0;
-          while(bytesUncompressed < item.size) {
-            size_t readSize = blockBuffer->Read(bufferIn, bytesRead, ppfBlockBufferReadSize);
-            if(readSize > 0) {
-              bool inflateFailure = false;
-              stream.avail_in = (uInt) readSize;
-              stream.next_in = (Bytef*) bufferIn;
-
-              do {
-                stream.avail_out = (uInt) ppfBlockBufferReadSize;
-                stream.next_out = (Bytef*) bufferOut;
-
-                int inflateResult = inflate(&stream, Z_NO_FLUSH);
-                if(inflateResult == Z_OK || inflateResult == Z_STREAM_END) {
-                  size_t uncompressedSize = ppfBlockBufferReadSize - stream.avail_out;
-                  uncompressedBlockBuffer->Append(bufferOut, uncompressedSize);
-                  bytesUncompressed += uncompressedSize;
-                }
-                else {
-                  inflateFailure = true;
-                  break;
-                }
-              }
-              while(stream.avail_in > 0 && stream.avail_out == 0);
-
-              if(inflateFailure)
-                break;
-
-              bytesRead += readSize;
-            }
-            else {
-              break;
-            }
+          if(blockBytes) {
+            free(blockBytes);
           }
-
-          inflateEnd(&stream);
-
-          free(bufferOut);
-          free(bufferIn);
-          delete blockBuffer;
-
-          blockBuffer = uncompressedBlockBuffer;
         }
       }
-    }
+    });
+
+    return success ? size : 0;
   }
 
-  return blockBuffer;
+  return 0;
 }
 
 void PrimePackFormat::AddItem(const std::string& path, void* data, size_t dataSize, bool replace) {
@@ -287,6 +408,7 @@ void PrimePackFormat::AddItem(const std::string& path, void* data, size_t dataSi
   }
 
   addedItems.erase(path);
+  directoriesValid = false;
 
   if(data && dataSize > 0) {
     size_t ppfBlockBufferBlockSize = PPFBlockBufferBlockSize;
@@ -318,94 +440,55 @@ void PrimePackFormat::InitFromData(const void* data, size_t dataSize) {
   if(data == nullptr || dataSize == 0)
     return;
 
-  bool dataIsPNG = false;
-
-  DataFile* file = new DataFile(data, dataSize);
-  if(file) {
-    if(dataSize >= 8 && png_sig_cmp((png_bytep) data, 0, 8) == 0) {
-      png_structp png;
-      png_infop pngInfo = nullptr;
-      png_infop pngEndInfo = nullptr;
-
-      dataIsPNG = true;
-
-      png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-      if(png) {
-        pngInfo = png_create_info_struct(png);
-        if(pngInfo) {
-          pngEndInfo = png_create_info_struct(png);
-          if(pngEndInfo) {
-            png_byte chunkList[] = {
-              "cPPF",
-            };
-
-            if(setjmp(png_jmpbuf(png))) {
-              goto endReadPNG;
-            }
-
-            png_set_keep_unknown_chunks(png, PNG_HANDLE_CHUNK_IF_SAFE, chunkList, 1);
-            png_set_read_user_chunk_fn(png, this, ReadPNGChunk);
-            png_set_read_fn(png, file, ReadPNGFromFile);
-            png_set_option(png, PNG_SKIP_sRGB_CHECK_PROFILE, PNG_OPTION_OFF);
-
-            if(setjmp(png_jmpbuf(png))) {
-              goto endReadPNG;
-            }
-
-            png_read_info(png, pngInfo);
-
-            uint32_t h = pngInfo->height;
-            for(uint32_t i = 0; i < h; i++) {
-              png_read_row(png, nullptr, nullptr);
-            }
-
-            if(setjmp(png_jmpbuf(png))) {
-              goto endReadPNG;
-            }
-
-            png_read_end(png, pngEndInfo);
-          }
-        }
-      }
-
-endReadPNG:
-      png_destroy_read_struct(&png, &pngInfo, &pngEndInfo);
+  // Only the pack itself is kept, so a PNG wrapper is stripped before copying.
+  if(PNGChunkReader::IsPNG(data, dataSize)) {
+    PNGChunk chunk;
+    if(!PNGChunkReader::FindChunk(data, dataSize, "cPPF", chunk) || chunk.size == 0) {
+      error = PrimePackFormatErrorChunkNotFoundInPNG;
+      return;
     }
 
-    delete file;
+    data = chunk.data;
+    dataSize = chunk.size;
   }
 
-  if(dataIsPNG && !loadChunk) {
-    error = PrimePackFormatErrorChunkNotFoundInPNG;
+  void* dataCopy = malloc(dataSize);
+  if(!dataCopy) {
+    error = PrimePackFormatErrorOutOfMemory;
     return;
   }
 
-  if(loadChunk) {
-    size_t chunkSize = loadChunkSize;
-    void* chunk = malloc(chunkSize);
-    if(chunk) {
-      memcpy(chunk, loadChunk, chunkSize);
-    }
-    else {
-      chunkSize = 0;
-    }
+  memcpy(dataCopy, data, dataSize);
+  InitFromData(std::shared_ptr<const void>(dataCopy, free), dataSize);
+}
 
-    SetLoadChunk(nullptr, 0);
+void PrimePackFormat::InitFromData(const std::shared_ptr<const void>& dataBuffer, size_t dataSize) {
+  const void* data = dataBuffer.get();
 
-    if(chunk) {
-      InitFromData(chunk, chunkSize);
-      if(chunk) {
-        free(chunk);
-      }
+  if(data == nullptr || dataSize == 0)
+    return;
+
+  directoriesValid = false;
+
+  // Packs wrapped in a PNG live in a cPPF chunk, found by walking chunk headers without decoding the image.
+  if(PNGChunkReader::IsPNG(data, dataSize)) {
+    PNGChunk chunk;
+    if(PNGChunkReader::FindChunk(data, dataSize, "cPPF", chunk) && chunk.size > 0) {
+      InitFromData(std::shared_ptr<const void>(dataBuffer, chunk.data), chunk.size);
     }
     else {
-      error = PrimePackFormatErrorOutOfMemory;
+      error = PrimePackFormatErrorChunkNotFoundInPNG;
     }
 
     return;
   }
 
-  file = new DataFile(data, dataSize);
+  // Items are read in place from here, so the buffer is kept rather than copied.
+  ppfBuffer = dataBuffer;
+  ppfBytes = (const uint8_t*) data;
+  ppfSize = dataSize;
+
+  DataFile* file = new DataFile(data, dataSize);
   if(file) {
     do {
       char header[sizeof(PrimePackFormatHeader)];
@@ -441,6 +524,12 @@ endReadPNG:
           }
         }
       }
+      else if(version == 3) {
+        error = ParseVersion3();
+        if(error) {
+          break;
+        }
+      }
       else {
         error = PrimePackFormatErrorUnknownVersion;
         break;
@@ -468,56 +557,155 @@ endReadPNG:
     }
     items.clear();
     metadata.clear();
+    memset(&v3Header, 0, sizeof(v3Header));
+    ppfBuffer.reset();
+    ppfBytes = nullptr;
+    ppfSize = 0;
   }
-  else {
-    size_t ptfBlockBufferBlockSize = PPFBlockBufferBlockSize;
-    size_t useBlockSize = ptfBlockBufferBlockSize;
-    if(useBlockSize > dataSize)
-      useBlockSize = dataSize;
+}
 
-    ppfData = new BlockBuffer(useBlockSize);
-    if(ppfData) {
-      ppfData->Append(data, dataSize);
-    }
-    else {
-      error = PrimePackFormatErrorOutOfMemory;
-    }
+void PrimePackFormat::InitFromFile(const std::string& path) {
+  size_t dataSize = 0;
+  std::shared_ptr<const void> data = MapFile(path, &dataSize);
+  if(!data) {
+    error = PrimePackFormatErrorFileNotFound;
+    return;
+  }
 
-    if(error) {
-      version = 0;
-      for(auto it: items) {
-        auto item = it.second;
-        if(item) {
-          delete item;
-        }
-      }
-      items.clear();
-      metadata.clear();
-    }
+  InitFromData(data, dataSize);
+}
+
+void PrimePackFormat::SetContentPath(const std::string& contentPath) {
+  this->contentPath = contentPath;
+}
+
+uint64_t PrimePackFormat::GetPathHash(const std::string& path) {
+  // FNV-1a.
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for(char c: path) {
+    hash ^= (uint8_t) c;
+    hash *= 0x100000001B3ULL;
   }
+
+  return hash;
 }
 
-void PrimePackFormat::SetLoadChunk(const void* chunk, size_t chunkSize) {
-  if(loadChunk) {
-    free(loadChunk);
-    loadChunk = nullptr;
+bool PrimePackFormat::FindItem(const std::string& path, PrimePackFormatItemLocation& location) const {
+  auto it = items.find(path);
+  if(it != items.end()) {
+    PrimePackFormatItem* item = it->second;
+    if(!item)
+      return false;
+
+    location.size = item->size;
+    location.dataSize = item->dataSize;
+    location.offset = item->offset;
+    location.compression = item->compression;
+    location.blockSize = 0;
+    location.firstBlock = 0;
+    return true;
   }
-  loadChunkSize = 0;
 
-  if(chunk && chunkSize > 0) {
-    loadChunkSize = chunkSize;
-    loadChunk = malloc(loadChunkSize);
-    if(loadChunk) {
-      memcpy(loadChunk, chunk, loadChunkSize);
-    }
-    else {
-      loadChunkSize = 0;
+  PrimePackFormatV3Entry entry;
+  if(FindEntry(path, entry)) {
+    location.size = entry.size;
+    location.dataSize = entry.dataSize;
+    location.offset = entry.dataOffset;
+    location.compression = entry.compression;
+    location.blockSize = entry.blockSize;
+    location.firstBlock = entry.firstBlock;
+    return true;
+  }
+
+  return false;
+}
+
+bool PrimePackFormat::FindEntry(const std::string& path, PrimePackFormatV3Entry& entry) const {
+  if(version != 3 || v3Header.itemCount == 0)
+    return false;
+
+  uint64_t hash = GetPathHash(path);
+  uint64_t mask = v3Header.tableSize - 1;
+  const uint8_t* table = ppfBytes + v3Header.tableOffset;
+  const uint8_t* strings = ppfBytes + v3Header.stringsOffset;
+
+  for(uint64_t i = 0; i < v3Header.tableSize; i++) {
+    uint32_t index;
+    memcpy(&index, table + ((hash + i) & mask) * sizeof(uint32_t), sizeof(index));
+
+    if(index == PrimePackFormatV3EmptySlot || !ReadEntry(index, entry))
+      return false;
+
+    if(entry.hash == hash && entry.pathSize == path.size() && IsRangeValid(entry.pathOffset, entry.pathSize, 1, v3Header.stringsSize)) {
+      if(memcmp(strings + entry.pathOffset, path.data(), path.size()) == 0)
+        return true;
     }
   }
+
+  return false;
 }
 
-void PrimePackFormat::SetContentPath(const std::string& contentPath) {
-  this->contentPath = contentPath;
+bool PrimePackFormat::ReadEntry(uint64_t index, PrimePackFormatV3Entry& entry) const {
+  if(index >= v3Header.itemCount)
+    return false;
+
+  // Entries are copied out because a pack embedded in a PNG has no alignment guarantee.
+  memcpy(&entry, ppfBytes + v3Header.entriesOffset + index * sizeof(PrimePackFormatV3Entry), sizeof(entry));
+  return true;
+}
+
+std::string PrimePackFormat::ReadString(uint64_t offset, uint64_t size) const {
+  if(!IsRangeValid(offset, size, 1, v3Header.stringsSize))
+    return std::string();
+
+  return std::string((const char*) ppfBytes + v3Header.stringsOffset + offset, (size_t) size);
+}
+
+bool PrimePackFormat::InflateBlock(const PrimePackFormatItemLocation& location, uint64_t block, void* p) const {
+  uint64_t blockIndex = location.firstBlock + block;
+  if(blockIndex >= v3Header.blockCount)
+    return false;
+
+  PrimePackFormatV3Block blockInfo;
+  memcpy(&blockInfo, ppfBytes + v3Header.blocksOffset + blockIndex * sizeof(PrimePackFormatV3Block), sizeof(blockInfo));
+
+  if(!IsRangeValid(blockInfo.offset, blockInfo.size, 1, ppfSize))
+    return false;
+
+  uint64_t blockStart = block * location.blockSize;
+  uint64_t blockSize = std::min((uint64_t) location.blockSize, location.size - blockStart);
+
+  return InflateData(ppfBytes + blockInfo.offset, (size_t) blockInfo.size, p, (size_t) blockSize);
+}
+
+void PrimePackFormat::BuildDirectories() const {
+  // Maps each directory ("" for the root, otherwise with a trailing slash) to
+  // its direct children; subdirectories are listed with their trailing slash.
+  directories.clear();
+
+  std::vector<std::string> paths;
+  GetItemPaths(paths);
+
+  for(const auto& path: paths) {
+    std::string child = path;
+    size_t slash = path.find_last_of('/');
+
+    while(true) {
+      std::string parent = slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+
+      auto& children = directories[parent];
+      bool parentExists = !children.empty();
+      children.push_back(child);
+
+      if(parentExists || parent.empty())
+        break;
+
+      child = parent;
+      slash = slash == 0 ? std::string::npos : path.find_last_of('/', slash - 1);
+    }
+  }
+
+  directoriesValid = true;
 }
 
 PrimePackFormatError PrimePackFormat::ParseVersion1(DataFile& file) {
@@ -624,13 +812,33 @@ PrimePackFormatError PrimePackFormat::ParseVersion2(DataFile& file) {
   return PrimePackFormatErrorNone;
 }
 
-void ReadPNGFromFile(png_structp png, png_bytep data, png_size_t size) {
-  DataFile* file = (DataFile*) png_get_io_ptr(png);
-  file->ReadBytes(data, size);
-}
+PrimePackFormatError PrimePackFormat::ParseVersion3() {
+  if(ppfSize < PrimePackFormatV3HeaderOffset + sizeof(PrimePackFormatV3Header))
+    return PrimePackFormatErrorInvalidFileSize;
+
+  memcpy(&v3Header, ppfBytes + PrimePackFormatV3HeaderOffset, sizeof(v3Header));
 
-int ReadPNGChunk(png_structp png, png_unknown_chunkp chunk) {
-  PrimePackFormat* ppf = (PrimePackFormat*) png_get_user_chunk_ptr(png);
-  ppf->SetLoadChunk(chunk->data, chunk->size);
-  return 1;
+  if(v3Header.fileSize != ppfSize)
+    return PrimePackFormatErrorInvalidFileSize;
+
+  // Lookups probe the table until they hit an empty slot, so it must be a power of two with one to spare.
+  if(v3Header.itemCount >= PrimePackFormatV3EmptySlot || (v3Header.tableSize & (v3Header.tableSize - 1)) != 0 || v3Header.tableSize <= v3Header.itemCount)
+    return PrimePackFormatErrorInvalidTable;
+
+  if(!IsRangeValid(v3Header.tableOffset, v3Header.tableSize, sizeof(uint32_t), ppfSize) ||
+     !IsRangeValid(v3Header.entriesOffset, v3Header.itemCount, sizeof(PrimePackFormatV3Entry), ppfSize) ||
+     !IsRangeValid(v3Header.blocksOffset, v3Header.blockCount, sizeof(PrimePackFormatV3Block), ppfSize) ||
+     !IsRangeValid(v3Header.metadataOffset, v3Header.metadataCount, sizeof(PrimePackFormatV3Metadata), ppfSize) ||
+     !IsRangeValid(v3Header.stringsOffset, v3Header.stringsSize, 1, ppfSize) ||
+     v3Header.packMetadataCount > v3Header.metadataCount)
+    return PrimePackFormatErrorInvalidTable;
+
+  // Only pack metadata is read up front; items are looked up through the table on demand.
+  for(uint32_t i = 0; i < v3Header.packMetadataCount; i++) {
+    PrimePackFormatV3Metadata entry;
+    memcpy(&entry, ppfBytes + v3Header.metadataOffset + i * sizeof(PrimePackFormatV3Metadata), sizeof(entry));
+    metadata[ReadString(entry.nameOffset, entry.nameSize)] = ReadString(entry.valueOffset, entry.valueSize);
+  }
+
+  return PrimePackFormatErrorNone;
 }
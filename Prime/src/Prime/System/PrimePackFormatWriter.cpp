@@ -0,0 +1,456 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Prime/System/PrimePackFormatWriter.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Prime/Config.h>
+#include <Prime/System/PNGChunkReader.h>
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+#include <zlib/zlib.h>
+
+using namespace Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// Structs
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  size_t itemIndex;
+  uint64_t hash;
+  uint32_t compression;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+  uint32_t firstBlock;
+  std::vector<std::vector<uint8_t>> blocks;
+} PrimePackFormatWriterBlob;
+
+////////////////////////////////////////////////////////////////////////////////
+// Constants
+////////////////////////////////////////////////////////////////////////////////
+
+static const char PrimePackFormatHeader[] = {'\xE3', 'P', 'P', 'F', '\x0D', '\x0A', '\x01', '\0'};
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t GetDataHash(const void* data, size_t dataSize) {
+  // FNV-1a, only used to find candidates for deduplication.
+  const uint8_t* p = (const uint8_t*) data;
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for(size_t i = 0; i < dataSize; i++) {
+    hash ^= p[i];
+    hash *= 0x100000001B3ULL;
+  }
+
+  return hash;
+}
+
+static uint64_t AlignOffset(uint64_t offset, uint32_t alignment) {
+  if(alignment <= 1)
+    return offset;
+
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+static void WriteU32BE(uint8_t* p, uint32_t value) {
+  p[0] = (uint8_t) (value >> 24);
+  p[1] = (uint8_t) (value >> 16);
+  p[2] = (uint8_t) (value >> 8);
+  p[3] = (uint8_t) value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+PrimePackFormatWriter::PrimePackFormatWriter():
+alignment(PrimePackFormatWriterDefaultAlignment),
+blockSize(PrimePackFormatWriterDefaultBlockSize),
+compressionLevel(PrimePackFormatWriterDefaultCompressionLevel),
+minCompressionRatio(PrimePackFormatWriterDefaultMinCompressionRatio) {
+  memset(&stats, 0, sizeof(stats));
+}
+
+PrimePackFormatWriter::~PrimePackFormatWriter() {
+
+}
+
+void PrimePackFormatWriter::AddItem(const std::string& path, const void* data, size_t dataSize, bool replace) {
+  const uint8_t* p = (const uint8_t*) data;
+  AddItem(path, p ? std::vector<uint8_t>(p, p + dataSize) : std::vector<uint8_t>(), replace);
+}
+
+void PrimePackFormatWriter::AddItem(const std::string& path, std::vector<uint8_t>&& data, bool replace) {
+  auto it = itemIndices.find(path);
+  if(it != itemIndices.end()) {
+    if(replace) {
+      items[it->second].data = std::move(data);
+    }
+
+    return;
+  }
+
+  itemIndices[path] = items.size();
+  items.push_back({path, std::move(data)});
+}
+
+bool PrimePackFormatWriter::HasItem(const std::string& path) const {
+  return itemIndices.find(path) != itemIndices.end();
+}
+
+void PrimePackFormatWriter::SetMetadata(const std::string& name, const std::string& value) {
+  for(auto& it: metadata) {
+    if(it.first == name) {
+      it.second = value;
+      return;
+    }
+  }
+
+  metadata.push_back({name, value});
+}
+
+void PrimePackFormatWriter::SetOrder(const std::vector<std::string>& paths) {
+  order.clear();
+  for(const auto& path: paths) {
+    order.insert({path, order.size()});
+  }
+}
+
+bool PrimePackFormatWriter::Write(std::vector<uint8_t>& ppf) {
+  memset(&stats, 0, sizeof(stats));
+  ppf.clear();
+
+  if(blockSize == 0 || items.size() >= PrimePackFormatV3EmptySlot)
+    return false;
+
+  // Items seen in the access order come first, in that order, so a load touches the pack front to back.
+  std::vector<size_t> itemOrder(items.size());
+  for(size_t i = 0; i < items.size(); i++) {
+    itemOrder[i] = i;
+  }
+
+  std::sort(itemOrder.begin(), itemOrder.end(), [&](size_t a, size_t b) {
+    auto itA = order.find(items[a].path);
+    auto itB = order.find(items[b].path);
+    if(itA != order.end() && itB != order.end())
+      return itA->second < itB->second;
+    if(itA != order.end() || itB != order.end())
+      return itA != order.end();
+    return items[a].path < items[b].path;
+  });
+
+  // Deduplicate by content. Hashes only pick candidates; matches are confirmed byte for byte.
+  std::vector<PrimePackFormatWriterBlob> blobs;
+  std::vector<size_t> itemBlobs(items.size());
+  std::unordered_multimap<uint64_t, size_t> blobHashes;
+
+  for(size_t itemIndex: itemOrder) {
+    const auto& data = items[itemIndex].data;
+    uint64_t hash = GetDataHash(data.data(), data.size());
+
+    size_t blobIndex = blobs.size();
+    auto range = blobHashes.equal_range(hash);
+    for(auto it = range.first; it != range.second; ++it) {
+      const auto& blobData = items[blobs[it->second].itemIndex].data;
+      if(blobData.size() == data.size() && memcmp(blobData.data(), data.data(), data.size()) == 0) {
+        blobIndex = it->second;
+        break;
+      }
+    }
+
+    if(blobIndex == blobs.size()) {
+      PrimePackFormatWriterBlob blob;
+      blob.itemIndex = itemIndex;
+      blob.hash = hash;
+      blob.compression = PrimePackFormatCompressionNone;
+      blob.dataOffset = 0;
+      blob.dataSize = data.size();
+      blob.firstBlock = 0;
+      blob.blocks.resize((data.size() + blockSize - 1) / blockSize);
+      blobs.push_back(std::move(blob));
+      blobHashes.insert({hash, blobIndex});
+    }
+
+    itemBlobs[itemIndex] = blobIndex;
+  }
+
+  // Every block of every unique item compresses independently, so they all go wide at once.
+  std::vector<std::pair<size_t, size_t>> tasks;
+  for(size_t i = 0; i < blobs.size(); i++) {
+    for(size_t j = 0; j < blobs[i].blocks.size(); j++) {
+      tasks.push_back({i, j});
+    }
+  }
+
+  std::atomic<bool> success(true);
+
+  Job::ParallelFor(0, tasks.size(), [&](size_t begin, size_t end) {
+    for(size_t i = begin; i < end && success; i++) {
+      auto& blob = blobs[tasks[i].first];
+      const auto& data = items[blob.itemIndex].data;
+      size_t offset = tasks[i].second * blockSize;
+      size_t size = std::min((size_t) blockSize, data.size() - offset);
+
+      auto& block = blob.blocks[tasks[i].second];
+      uLongf blockDataSize = compressBound((uLong) size);
+      block.resize(blockDataSize);
+
+      if(compress2(block.data(), &blockDataSize, data.data() + offset, (uLong) size, compressionLevel) != Z_OK) {
+        success = false;
+      }
+
+      block.resize(blockDataSize);
+    }
+  }, 1);
+
+  if(!success)
+    return false;
+
+  // Items that barely compress are stored, so they can be read in place.
+  uint32_t blockCount = 0;
+  for(auto& blob: blobs) {
+    uint64_t compressedSize = 0;
+    for(const auto& block: blob.blocks) {
+      compressedSize += block.size();
+    }
+
+    if(blob.blocks.empty() || compressedSize >= (uint64_t) (blob.dataSize * minCompressionRatio)) {
+      blob.blocks.clear();
+    }
+    else if(blob.blocks.size() == 1) {
+      blob.compression = PrimePackFormatCompressionZlib;
+      blob.dataSize = compressedSize;
+    }
+    else {
+      if((uint64_t) blockCount + blob.blocks.size() > UINT32_MAX)
+        return false;
+
+      blob.compression = PrimePackFormatCompressionZlibBlocks;
+      blob.dataSize = compressedSize;
+      blob.firstBlock = blockCount;
+      blockCount += (uint32_t) blob.blocks.size();
+    }
+  }
+
+  std::string strings;
+  std::vector<PrimePackFormatV3Metadata> metadataEntries;
+  for(const auto& it: metadata) {
+    PrimePackFormatV3Metadata entry;
+    entry.nameOffset = (uint32_t) strings.size();
+    entry.nameSize = (uint32_t) it.first.size();
+    strings += it.first;
+    entry.valueOffset = (uint32_t) strings.size();
+    entry.valueSize = (uint32_t) it.second.size();
+    strings += it.second;
+    metadataEntries.push_back(entry);
+  }
+
+  std::vector<PrimePackFormatV3Entry> entries(items.size());
+  for(size_t i = 0; i < itemOrder.size(); i++) {
+    const Item& item = items[itemOrder[i]];
+    PrimePackFormatV3Entry& entry = entries[i];
+    memset(&entry, 0, sizeof(entry));
+    entry.hash = PrimePackFormat::GetPathHash(item.path);
+    entry.pathOffset = (uint32_t) strings.size();
+    entry.pathSize = (uint32_t) item.path.size();
+    entry.size = item.data.size();
+    strings += item.path;
+  }
+
+  if(strings.size() > UINT32_MAX)
+    return false;
+
+  // Keeping the table at most half full bounds probe lengths.
+  size_t tableSlots = GetNextPowerOf2(items.size() * 2 + 1);
+  if(tableSlots > UINT32_MAX)
+    return false;
+
+  uint32_t tableSize = (uint32_t) tableSlots;
+
+  PrimePackFormatV3Header header;
+  memset(&header, 0, sizeof(header));
+  header.alignment = alignment;
+  header.tableSize = tableSize;
+  header.itemCount = items.size();
+  header.tableOffset = PrimePackFormatV3HeaderOffset + sizeof(header);
+  header.entriesOffset = header.tableOffset + tableSize * sizeof(uint32_t);
+  header.blocksOffset = header.entriesOffset + entries.size() * sizeof(PrimePackFormatV3Entry);
+  header.blockCount = blockCount;
+  header.metadataOffset = header.blocksOffset + blockCount * sizeof(PrimePackFormatV3Block);
+  header.metadataCount = metadataEntries.size();
+  header.stringsOffset = header.metadataOffset + metadataEntries.size() * sizeof(PrimePackFormatV3Metadata);
+  header.stringsSize = strings.size();
+  header.packMetadataCount = (uint32_t) metadataEntries.size();
+
+  // Stored items start on an alignment boundary so they can be mapped and used in place; streams pack tightly.
+  std::vector<PrimePackFormatV3Block> blocks(blockCount);
+  uint64_t offset = AlignOffset(header.stringsOffset + header.stringsSize, alignment);
+
+  for(auto& blob: blobs) {
+    if(blob.compression == PrimePackFormatCompressionNone) {
+      offset = AlignOffset(offset, alignment);
+    }
+
+    blob.dataOffset = offset;
+
+    if(blob.compression == PrimePackFormatCompressionZlibBlocks) {
+      for(size_t i = 0; i < blob.blocks.size(); i++) {
+        blocks[blob.firstBlock + i].offset = offset;
+        blocks[blob.firstBlock + i].size = blob.blocks[i].size();
+        offset += blob.blocks[i].size();
+      }
+    }
+    else {
+      offset += blob.dataSize;
+    }
+  }
+
+  header.fileSize = offset;
+
+  for(size_t i = 0; i < itemOrder.size(); i++) {
+    const auto& blob = blobs[itemBlobs[itemOrder[i]]];
+    PrimePackFormatV3Entry& entry = entries[i];
+    entry.dataOffset = blob.dataOffset;
+    entry.dataSize = blob.dataSize;
+    entry.compression = blob.compression;
+    entry.blockSize = blob.compression == PrimePackFormatCompressionZlibBlocks ? blockSize : 0;
+    entry.firstBlock = blob.firstBlock;
+  }
+
+  std::vector<uint32_t> table(tableSize, PrimePackFormatV3EmptySlot);
+  for(size_t i = 0; i < entries.size(); i++) {
+    uint32_t slot = (uint32_t) (entries[i].hash & (tableSize - 1));
+    while(table[slot] != PrimePackFormatV3EmptySlot) {
+      slot = (slot + 1) & (tableSize - 1);
+    }
+
+    table[slot] = (uint32_t) i;
+  }
+
+  if(header.fileSize > SIZE_MAX)
+    return false;
+
+  ppf.resize((size_t) header.fileSize, 0);
+  uint8_t* p = ppf.data();
+
+  memcpy(p, PrimePackFormatHeader, sizeof(PrimePackFormatHeader));
+  p[sizeof(PrimePackFormatHeader)] = 3;
+  memcpy(p + PrimePackFormatV3HeaderOffset, &header, sizeof(header));
+  memcpy(p + header.tableOffset, table.data(), table.size() * sizeof(uint32_t));
+  if(!entries.empty()) {
+    memcpy(p + header.entriesOffset, entries.data(), entries.size() * sizeof(PrimePackFormatV3Entry));
+  }
+  if(!blocks.empty()) {
+    memcpy(p + header.blocksOffset, blocks.data(), blocks.size() * sizeof(PrimePackFormatV3Block));
+  }
+  if(!metadataEntries.empty()) {
+    memcpy(p + header.metadataOffset, metadataEntries.data(), metadataEntries.size() * sizeof(PrimePackFormatV3Metadata));
+  }
+  memcpy(p + header.stringsOffset, strings.data(), strings.size());
+
+  for(const auto& blob: blobs) {
+    uint64_t blobOffset = blob.dataOffset;
+    if(blob.compression == PrimePackFormatCompressionNone) {
+      const auto& data = items[blob.itemIndex].data;
+      if(!data.empty()) {
+        memcpy(p + blobOffset, data.data(), data.size());
+      }
+    }
+    else {
+      for(const auto& block: blob.blocks) {
+        memcpy(p + blobOffset, block.data(), block.size());
+        blobOffset += block.size();
+      }
+    }
+  }
+
+  stats.itemCount = items.size();
+  stats.uniqueItemCount = blobs.size();
+  for(const auto& item: items) {
+    stats.itemSize += item.data.size();
+  }
+  for(const auto& blob: blobs) {
+    stats.dataSize += blob.dataSize;
+    if(blob.compression != PrimePackFormatCompressionNone) {
+      stats.compressedItemCount++;
+    }
+  }
+  stats.fileSize = header.fileSize;
+
+  return true;
+}
+
+bool PrimePackFormatWriter::EmbedInPNG(const void* png, size_t pngSize, const void* ppf, size_t ppfSize, std::vector<uint8_t>& result) {
+  result.clear();
+
+  // PNG chunk lengths are limited to 31 bits.
+  if(ppfSize > 0x7FFFFFFF)
+    return false;
+
+  // The pack goes in a cPPF chunk just before IEND, replacing any existing one.
+  const uint8_t* p = (const uint8_t*) png;
+  PNGChunkReader reader(png, pngSize);
+  if(!reader.IsValid())
+    return false;
+
+  size_t copyStart = 0;
+  result.reserve(pngSize + ppfSize + 12);
+
+  while(reader.Next()) {
+    const PNGChunk& chunk = reader.GetChunk();
+    size_t chunkStart = (const uint8_t*) chunk.data - p - 8;
+    size_t chunkEnd = (const uint8_t*) chunk.data - p + chunk.size + 4;
+
+    if(strcmp(chunk.type, "cPPF") == 0) {
+      result.insert(result.end(), p + copyStart, p + chunkStart);
+      copyStart = chunkEnd;
+    }
+    else if(strcmp(chunk.type, "IEND") == 0) {
+      result.insert(result.end(), p + copyStart, p + chunkStart);
+
+      size_t chunkOffset = result.size();
+      result.resize(chunkOffset + ppfSize + 12);
+      uint8_t* c = result.data() + chunkOffset;
+      WriteU32BE(c, (uint32_t) ppfSize);
+      memcpy(c + 4, "cPPF", 4);
+      memcpy(c + 8, ppf, ppfSize);
+      WriteU32BE(c + 8 + ppfSize, (uint32_t) crc32(crc32(0, nullptr, 0), c + 4, (uInt) (ppfSize + 4)));
+
+      result.insert(result.end(), p + chunkStart, p + pngSize);
+      return true;
+    }
+  }
+
+  result.clear();
+  return false;
+}
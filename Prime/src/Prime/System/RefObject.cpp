@@ -106,18 +106,22 @@ void RefObject::GetContent(const std::string& uri, const std::function<void (Con
 }
 
 void RefObject::GetContent(const std::string& uri, const json& info, const std::function<void (Content*)>& callback) {
+  GetContent(uri, info, CancelToken(), callback);
+}
+
+void RefObject::GetContent(const std::string& uri, const json& info, const CancelToken& cancel, const std::function<void (Content*)>& callback) {
   IncRef();
 
   refptr content = dynamic_cast<Content*>(this);
   if(content) {
     const std::string& contentURI = content->GetURI();
-    Prime::GetContent(uri, info + json({{"_parentURI", contentURI}}), [=](Content* content) {
+    Prime::GetContent(uri, info + json({{"_parentURI", contentURI}}), cancel, [=](Content* content) {
       callback(content);
       DecRef();
     });
   }
   else {
-    Prime::GetContent(uri, info, [=](Content* content) {
+    Prime::GetContent(uri, info, cancel, [=](Content* content) {
       callback(content);
       DecRef();
     });
@@ -154,9 +158,30 @@ void RefObject::SendURL(const std::string& url, const std::function<void(const j
 }
 
 void RefObject::SendURL(const std::string& url, const json& params, const std::function<void(const json&)>& callback) {
+  SendURL(url, params, CancelToken(), callback);
+}
+
+void RefObject::SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&)>& callback) {
   IncRef();
-  Prime::SendURL(url, [=](const json& response) {
+  Prime::SendURL(url, params, cancel, [=](const json& response) {
     callback(response);
     DecRef();
   });
 }
+
+void RefObject::SendURL(const std::string& url, const std::function<void(const json&, const DataBuffer&)>& callback) {
+  json params;
+  SendURL(url, params, callback);
+}
+
+void RefObject::SendURL(const std::string& url, const json& params, const std::function<void(const json&, const DataBuffer&)>& callback) {
+  SendURL(url, params, CancelToken(), callback);
+}
+
+void RefObject::SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&, const DataBuffer&)>& callback) {
+  IncRef();
+  Prime::SendURL(url, params, cancel, [=](const json& response, const DataBuffer& data) {
+    callback(response, data);
+    DecRef();
+  });
+}
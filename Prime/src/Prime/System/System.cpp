@@ -43,9 +43,16 @@ SOFTWARE.
 #include <jpeg/jpeglib.h>
 #include <jpeg/jerror.h>
 #include <jsmn/jsmn.h>
+#include <list>
 
 using namespace Prime;
 
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+#define ContentReferencesPath "/ContentReferences.json"
+
 ////////////////////////////////////////////////////////////////////////////////
 // Structs
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,11 +60,51 @@ using namespace Prime;
 struct jpegErrorManager {
   struct jpeg_error_mgr pub;
   jmp_buf setjmp_buffer;
+  char lastErrorMsg[JMSG_LENGTH_MAX];
 };
 
-static char jpegLastErrorMsg[JMSG_LENGTH_MAX];
 static void jpegErrorExit(j_common_ptr cinfo);
 
+typedef struct {
+  std::function<bool (const void*, size_t, const json&)> match;
+  std::function<Content* ()> create;
+  // Also checked for an embedded PrimePackFormat.
+  bool pack;
+} ContentLoader;
+
+// Raw pointers only, refcounts are main thread only and the response adopts them.
+typedef struct ContentLoadResult {
+  Content* content;
+  PrimePackFormat* ppf;
+
+  ContentLoadResult():
+  content(nullptr),
+  ppf(nullptr) {
+
+  }
+} ContentLoadResult;
+
+typedef struct ContentLoadRequest {
+  std::function<void (Content*)> callback;
+  CancelToken cancel;
+  size_t cancelID;
+
+  ContentLoadRequest():
+  cancelID(0) {
+
+  }
+} ContentLoadRequest;
+
+typedef struct {
+  Stack<ContentLoadRequest> requests;
+  CancelToken cancel;
+} ContentLoad;
+
+typedef struct {
+  std::list<std::string>::iterator lru;
+  size_t size;
+} ContentUnused;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Classes
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,13 +139,27 @@ ContentPPF::~ContentPPF() {
 // Variables
 ////////////////////////////////////////////////////////////////////////////////
 
-static ThreadMutex* setjmpMutex = nullptr;
 static ThreadMutex* contentDataMutex = nullptr;
 static Dictionary<std::string, refptr<Content>> contentData;
-static Dictionary<std::string, bool> contentDataLoadingLocked;
-static Dictionary<std::string, size_t> contentDataLoading;
+static Dictionary<std::string, ContentLoad> contentLoads;
+static Dictionary<std::string, f64> contentReleased;
+static f64 contentReleaseDelay = 0.0;
+static Dictionary<std::string, ContentUnused> contentUnused;
+static std::list<std::string> contentUnusedLRU;
+static size_t contentUnusedSize = 0;
+static size_t contentCacheBudget = 0;
+static size_t contentHits = 0;
+static size_t contentMisses = 0;
+static size_t contentJoins = 0;
+static size_t contentEvictions = 0;
 static Dictionary<std::string, refptr<ContentPPF>> contentPPFItems;
+static Dictionary<std::string, ContentPPF*> contentPPFPaths;
 static Dictionary<std::string, std::string> contentURIMap;
+static Dictionary<std::string, Stack<std::string>> contentReferences;
+static Dictionary<std::string, Stack<refptr<Content>>> contentPrefetched;
+static bool contentPrefetch = true;
+static Stack<ContentLoader> contentLoaders;
+static Dictionary<std::string, std::function<Content* ()>> contentClasses;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Functions
@@ -109,14 +170,36 @@ void InitContent();
 void ShutdownContent();
 void ProcessContentRefs();
 void ReleaseAllContent();
+void OnContentReleased(Content* content);
+
+static void GetContentByData(const std::string& uri, const std::shared_ptr<const void>& dataBuffer, size_t dataSize, const json& info, const std::function<void (Content*)>& callback);
 
-static void GetContentByData(const std::string& uri, const void* data, size_t dataSize, const json& info, const std::function<void (Content*)>& callback);
+static void UseCachedContent(const std::string& uri, Content* content, const std::function<void (Content*)>& callback);
+static void AddUnusedContent(const std::string& uri, Content* content);
+static void RemoveUnusedContent(const std::string& uri);
+static void EvictUnusedContent();
 
-static bool IncContentDataLoading(const std::string& uri);
-static void DecContentDataLoading(const std::string& uri, bool locked);
-static void WaitForContentDataLoading(const std::string& uri);
-static void OnContentLoadingDone(Content* content, const std::string& uri, bool locked, const std::function<void (Content*)>& callback);
+static bool AttachContentLoad(const std::string& uri, const CancelToken& cancel, const std::function<void (Content*)>& callback);
+static CancelToken StartContentLoad(const std::string& uri, const json& info, const CancelToken& cancel, const std::function<void (Content*)>& callback);
+static void AddContentLoadRequest(const std::string& uri, const CancelToken& cancel, const std::function<void (Content*)>& callback);
+static void CancelAbandonedContentLoad(const std::string& uri);
+static void FinishContentLoad(const std::string& uri, const CancelToken& loadCancel, Content* content);
 static void SetupLoadingContent(Content* content, const std::string& uri, const json& info);
+
+static void AddContentPPF(const std::string& uri, ContentPPF* contentPPF);
+static void IndexContentPPF(ContentPPF* contentPPF);
+static ContentPPF* FindContentPPFItem(const std::string& uri, const json& info, std::string& itemPath, std::string& itemURI);
+static std::shared_ptr<const void> GetContentPPFItemData(ContentPPF* contentPPF, const std::string& itemPath, size_t& dataSize);
+static JobPriority GetContentPriority(const json& info);
+
+static void RegisterContentLoader(const std::function<bool (const void*, size_t, const json&)>& match, const std::function<Content* ()>& create, bool pack);
+static bool FindContentLoader(const void* data, size_t dataSize, const json& info, ContentLoader& loader);
+static Content* CreateContentFromJSON(const json& data);
+static bool IsFormatJSONDelimited(const void* data, size_t dataSize);
+
+static void PrefetchRecordedContentReferences(const std::string& uri, const json& info);
+static void PrefetchLoadedContentReferences(const std::string& uri, Content* content, const json& info);
+static void PrefetchContentReferences(const std::string& uri, const Stack<std::string>& references, const json& info);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,85 +212,79 @@ void Prime::GetContent(const std::string& uri, const std::function<void (Content
 }
 
 void Prime::GetContent(const std::string& uri, const json& info, const std::function<void (Content*)>& callback) {
+  GetContent(uri, info, CancelToken(), callback);
+}
+
+void Prime::GetContent(const std::string& uri, const json& info, const CancelToken& cancel, const std::function<void (Content*)>& callback) {
   PxRequireMainThread;
 
   const std::string& mappedURI = GetMapppedContentURI(uri);
 
-  if(mappedURI.empty()) {
+  if(mappedURI.empty() || cancel.IsCancelled()) {
     callback(nullptr);
     return;
   }
 
   if(auto it = contentData.Find(mappedURI)) {
-    callback(it.value());
+    UseCachedContent(mappedURI, it.value(), callback);
     return;
   }
 
-  for(auto it: contentPPFItems) {
-    auto ppf = it.value()->GetPPF();
-    const std::string& ppfContentPath = ppf->GetContentPath();
-
-    if(StartsWith(uri, ppfContentPath)) {
-      std::string subPath = uri.substr(ppfContentPath.length());
-      if(ppf->HasItem(subPath)) {
-        BlockBuffer* blockBuffer = ppf->GetItemData(subPath);
-        if(blockBuffer) {
-          size_t dataSize;
-          void* data = blockBuffer->ConvertToBytes(&dataSize);
-          delete blockBuffer;
-          if(data) {
-            GetContentByData(uri, data, dataSize, info, callback);
-            free(data);
-            return;
-          }
-        }
-      }
-    }
-
-    if(auto it = info.find("_parentURI")) {
-      std::string parentURI = it.GetString();
-      if(!parentURI.empty()) {
-        if(StartsWith(parentURI, ppfContentPath)) {
-          if(ppf->HasItem(uri)) {
-            BlockBuffer* blockBuffer = ppf->GetItemData(uri);
-            if(blockBuffer) {
-              size_t dataSize;
-              void* data = blockBuffer->ConvertToBytes(&dataSize);
-              delete blockBuffer;
-              if(data) {
-                std::string useURI = ppfContentPath + uri;
-                GetContentByData(useURI, data, dataSize, info, callback);
-                free(data);
-                return;
-              }
-            }
-          }
-        }
-      }
+  // Requests for a URI that is already loading join that load rather than starting another.
+  std::string itemPath;
+  std::string itemURI;
+  if(ContentPPF* contentPPF = FindContentPPFItem(uri, info, itemPath, itemURI)) {
+    if(AttachContentLoad(itemURI, cancel, callback))
+      return;
+
+    size_t dataSize;
+    std::shared_ptr<const void> data = GetContentPPFItemData(contentPPF, itemPath, dataSize);
+    if(data) {
+      CancelToken loadCancel = StartContentLoad(itemURI, info, cancel, callback);
+      GetContentByData(itemURI, data, dataSize, info, [=](Content* content) {
+        FinishContentLoad(itemURI, loadCancel, content);
+      });
+      return;
     }
   }
 
+  if(AttachContentLoad(mappedURI, cancel, callback))
+    return;
+
+  CancelToken loadCancel = StartContentLoad(mappedURI, info, cancel, callback);
+
   std::string lowerURI = ToLower(mappedURI);
 
+  // The download is only cancelled once every request waiting on it has been.
   if(StartsWith(lowerURI, "http")) {
-    SendURL(mappedURI, [=](const json& response) {
-      if(auto it = response.find("data")) {
-        size_t dataSize;
-        const void* data = it.GetStringData(&dataSize);
-        GetContentByData(mappedURI, data, dataSize, info, callback);
+    json params;
+    if(auto it = info.find("_priority")) {
+      params["priority"] = it.GetString();
+    }
+
+    SendURL(mappedURI, params, loadCancel, [=](const json& response, const DataBuffer& data) {
+      if(data && !loadCancel.IsCancelled()) {
+        GetContentByData(mappedURI, std::shared_ptr<const void>(data, data->data()), data->size(), info, [=](Content* content) {
+          FinishContentLoad(mappedURI, loadCancel, content);
+        });
       }
       else {
-        callback(nullptr);
+        FinishContentLoad(mappedURI, loadCancel, nullptr);
       }
     });
   }
   else {
-    ReadFile(mappedURI, [=](void* data, size_t dataSize) {
-      GetContentByData(mappedURI, data, dataSize, info, callback);
-      if(data) {
-        free(data);
+    // Mapped rather than read, so packs and stored items can be used in place.
+    MapFile(mappedURI, [=](const std::shared_ptr<const void>& data, size_t dataSize) {
+      if(loadCancel.IsCancelled()) {
+        FinishContentLoad(mappedURI, loadCancel, nullptr);
+        return;
       }
-    });
+
+      GetContentByData(mappedURI, data, dataSize, info, [=](Content* content) {
+        FinishContentLoad(mappedURI, loadCancel, content);
+      });
+    }, GetContentPriority(info));
   }
 }
 
@@ -226,57 +303,23 @@ void Prime::GetContentRaw(const std::string& uri, const json& info, const std::f
     return;
   }
 
-  for(auto it: contentPPFItems) {
-    auto ppf = it.value()->GetPPF();
-    const std::string& ppfContentPath = ppf->GetContentPath();
-
-    if(StartsWith(uri, ppfContentPath)) {
-      std::string subPath = uri.substr(ppfContentPath.length());
-      if(ppf->HasItem(subPath)) {
-        BlockBuffer* blockBuffer = ppf->GetItemData(subPath);
-        if(blockBuffer) {
-          size_t dataSize;
-          void* data = blockBuffer->ConvertToBytes(&dataSize);
-          delete blockBuffer;
-          if(data) {
-            callback(data, dataSize);
-            free(data);
-            return;
-          }
-        }
-      }
-    }
-
-    if(auto it = info.find("_parentURI")) {
-      std::string parentURI = it.GetString();
-      if(!parentURI.empty()) {
-        if(StartsWith(parentURI, ppfContentPath)) {
-          if(ppf->HasItem(uri)) {
-            BlockBuffer* blockBuffer = ppf->GetItemData(uri);
-            if(blockBuffer) {
-              size_t dataSize;
-              void* data = blockBuffer->ConvertToBytes(&dataSize);
-              delete blockBuffer;
-              if(data) {
-                callback(data, dataSize);
-                free(data);
-                return;
-              }
-            }
-          }
-        }
-      }
+  std::string itemPath;
+  std::string itemURI;
+  if(ContentPPF* contentPPF = FindContentPPFItem(uri, info, itemPath, itemURI)) {
+    size_t dataSize;
+    std::shared_ptr<const void> data = GetContentPPFItemData(contentPPF, itemPath, dataSize);
+    if(data) {
+      callback(data.get(), dataSize);
+      return;
     }
   }
 
   std::string lowerURI = ToLower(mappedURI);
 
   if(StartsWith(lowerURI, "http")) {
-    SendURL(mappedURI, [=](const json& response) {
-      if(auto it = response.find("data")) {
-        size_t dataSize;
-        const void* data = it.GetStringData(&dataSize);
-        callback(data, dataSize);
+    SendURL(mappedURI, json(), [=](const json& response, const DataBuffer& data) {
+      if(data) {
+        callback(data->data(), data->size());
       }
       else {
         callback(nullptr, 0);
@@ -289,7 +332,7 @@ void Prime::GetContentRaw(const std::string& uri, const json& info, const std::f
       if(data) {
         free(data);
       }
-    });
+    }, GetContentPriority(info));
   }
 }
 
@@ -323,17 +366,133 @@ void Prime::GetPackFilenames(const std::string& uri, Stack<std::string>& filenam
   }
 }
 
-bool Prime::LockSetjmpMutex() {
-  return setjmpMutex->Lock();
+void Prime::GetPackDirectoryFilenames(const std::string& uri, const std::string& directory, Stack<std::string>& filenames) {
+  if(auto it = contentPPFItems.Find(uri)) {
+    auto ppf = it.value()->GetPPF();
+
+    std::vector<std::string> filenamesVector;
+    ppf->GetDirectoryPaths(directory, filenamesVector);
+
+    for(auto& filename: filenamesVector) {
+      filenames.Add(filename);
+    }
+  }
+}
+
+void Prime::SetContentPrefetch(bool enabled) {
+  PxRequireMainThread;
+
+  contentPrefetch = enabled;
+}
+
+void Prime::SetContentReleaseDelay(f64 seconds) {
+  PxRequireMainThread;
+
+  contentReleaseDelay = seconds;
+}
+
+void Prime::SetContentCacheBudget(size_t bytes) {
+  PxRequireMainThread;
+
+  contentCacheBudget = bytes;
+  EvictUnusedContent();
 }
 
-bool Prime::UnlockSetjmpMutex() {
-  return setjmpMutex->Unlock();
+json Prime::GetContentStats() {
+  PxRequireMainThread;
+
+  size_t cpuSize = 0;
+  size_t gpuSize = 0;
+
+  for(auto it: contentData) {
+    cpuSize += it.value()->GetCPUSize();
+    gpuSize += it.value()->GetGPUSize();
+  }
+
+  json stats;
+
+  stats["count"] = contentData.GetCount();
+  stats["cpuSize"] = cpuSize;
+  stats["gpuSize"] = gpuSize;
+  stats["loading"] = contentLoads.GetCount();
+  stats["unusedCount"] = contentUnused.GetCount();
+  stats["unusedSize"] = contentUnusedSize;
+  stats["budget"] = contentCacheBudget;
+  stats["hits"] = contentHits;
+  stats["misses"] = contentMisses;
+  stats["joins"] = contentJoins;
+  stats["evictions"] = contentEvictions;
+
+  return stats;
+}
+
+void Prime::AddContentReferences(const json& references, const std::string& basePath) {
+  PxRequireMainThread;
+
+  for(auto& it: references) {
+    if(!it.IsArray())
+      continue;
+
+    Stack<std::string> paths;
+    for(auto& path: it) {
+      if(path.IsString()) {
+        paths.Add(path.GetString());
+      }
+    }
+
+    contentReferences[basePath + it.key().GetString()] = paths;
+  }
+}
+
+json Prime::GetContentReferences(const std::string& basePath) {
+  PxRequireMainThread;
+
+  json result;
+  result.object();
+
+  for(auto it: contentReferences) {
+    const std::string& uri = it.key();
+    if(!StartsWith(uri, basePath))
+      continue;
+
+    auto itPaths = result[uri.substr(basePath.length())];
+    itPaths.array();
+    for(const auto& path: it.value()) {
+      itPaths.append(path.c_str());
+    }
+  }
+
+  return result;
+}
+
+void Prime::RegisterContentLoader(const std::function<bool (const void*, size_t, const json&)>& match, const std::function<Content* ()>& create) {
+  RegisterContentLoader(match, create, false);
+}
+
+void Prime::RegisterContentClass(const std::string& className, const std::function<Content* ()>& create) {
+  PxRequireMainThread;
+
+  contentDataMutex->Lock();
+  contentClasses[className] = create;
+  contentDataMutex->Unlock();
 }
 
 void Prime::InitContent() {
   contentDataMutex = new ThreadMutex("Content Data");
-  setjmpMutex = new ThreadMutex("setjmp", true);
+
+  // Checked in registration order. BC is only ever selected through info, so it goes first.
+  RegisterContentLoader(IsFormatBC, []() -> Content* {return new ImagemapContent();}, false);
+  RegisterContentLoader(IsFormatPNG, []() -> Content* {return new ImagemapContent();}, true);
+  RegisterContentLoader(IsFormatGLTF, []() -> Content* {return new ModelContent();}, false);
+  RegisterContentLoader(IsFormatFBX, []() -> Content* {return new ModelContent();}, false);
+  RegisterContentLoader(IsFormatJPEG, []() -> Content* {return new ImagemapContent();}, false);
+  RegisterContentLoader(IsFormatOTF, []() -> Content* {return new FontContent();}, false);
+
+  RegisterContentClass("Imagemap", []() -> Content* {return new ImagemapContent();});
+  RegisterContentClass("Skinset", []() -> Content* {return new SkinsetContent();});
+  RegisterContentClass("Skeleton", []() -> Content* {return new SkeletonContent();});
+  RegisterContentClass("Model", []() -> Content* {return new ModelContent();});
+  RegisterContentClass("Rig", []() -> Content* {return new RigContent();});
 
   GetContent("data/Tex/Default.png", [=](Content* content) {
     if(content->IsInstance<ImagemapContent>()) {
@@ -345,159 +504,145 @@ void Prime::InitContent() {
 void Prime::ShutdownContent() {
   ModelContent::defaultTex = nullptr;
 
-  PrimeSafeDelete(setjmpMutex);
+  contentLoaders.Clear();
+  contentClasses.Clear();
+
   PrimeSafeDelete(contentDataMutex);
 }
 
 void Prime::ProcessContentRefs() {
+  if(contentReleased.GetCount() == 0)
+    return;
+
+  // Only content released since it was last looked at is visited, not the whole cache.
+  f64 time = GetSystemTime();
+
   Stack<std::string> removeURIs;
+  Stack<std::string> reusedURIs;
 
-  for(auto it: contentData) {
+  for(auto it: contentReleased) {
     const std::string& uri = it.key();
 
-    Content* content = it.value();
-    if(content->GetRefCount() == 1) {
-      bool remove = true;
+    auto itContent = contentData.Find(uri);
+    if(!itContent || itContent.value()->GetRefCount() != 1) {
+      reusedURIs.Push(uri);
+    }
+    else if(time - it.value() >= contentReleaseDelay) {
+      removeURIs.Push(uri);
+    }
+  }
 
-      contentDataMutex->Lock();
-      if(auto itLoadingLocked = contentDataLoadingLocked.Find(uri)) {
-        remove = false;
-      }
-      if(remove) {
-        if(auto itLoading = contentDataLoading.Find(uri)) {
-          remove = false;
-        }
-      }
-      contentDataMutex->Unlock();
+  for(const auto& uri: reusedURIs) {
+    contentReleased.Remove(uri);
+  }
 
-      if(remove) {
-        removeURIs.Push(it.key());
+  for(const auto& uri: removeURIs) {
+    contentReleased.Remove(uri);
+
+    // Prefetched references are let go with their parent, so each one is released and charged to the budget on its own.
+    contentPrefetched.Remove(uri);
+
+    if(contentCacheBudget > 0) {
+      if(auto itContent = contentData.Find(uri)) {
+        AddUnusedContent(uri, itContent.value());
       }
     }
+    else {
+      contentData.Remove(uri);
+    }
   }
 
-  for(const auto& uri: removeURIs) {
-    contentData.Remove(uri);
-  }
+  EvictUnusedContent();
 }
 
 void Prime::ReleaseAllContent() {
   ProcessContentRefs();
+  contentUnused.Clear();
+  contentUnusedLRU.clear();
+  contentUnusedSize = 0;
+  contentPrefetched.Clear();
+  contentPPFPaths.Clear();
   contentPPFItems.Clear();
   contentData.Clear();
+  contentReleased.Clear();
 }
 
-void Prime::GetContentByData(const std::string& uri, const void* data, size_t dataSize, const json& info, const std::function<void (Content*)>& callback) {
-  if(data == nullptr || dataSize == 0) {
-    callback(nullptr);
+void Prime::UseCachedContent(const std::string& uri, Content* content, const std::function<void (Content*)>& callback) {
+  contentHits++;
+
+  RemoveUnusedContent(uri);
+
+  // Held across the callback, so content nobody keeps is seen as released again.
+  refptr<Content> cachedContent = content;
+  callback(content);
+}
+
+void Prime::AddUnusedContent(const std::string& uri, Content* content) {
+  if(contentUnused.HasKey(uri))
     return;
-  }
 
-  if(IsFormatBC(data, dataSize, info)) {
-    bool locked = IncContentDataLoading(uri);
-    refptr<ImagemapContent> content;
-    if(locked) {
-      content = new ImagemapContent();
-    }
+  contentUnusedLRU.push_front(uri);
 
-    std::string dataCopy((const char*) data, dataSize);
-    new Job([=](Job& job) {
-      if(locked) {
-        if(content) {
-          SetupLoadingContent(content, uri, info);
-          content->Load(dataCopy.c_str(), dataCopy.size(), info);
-        }
-      }
-      else {
-        WaitForContentDataLoading(uri);
-      }
-    }, [=](Job& job) {
-      OnContentLoadingDone(content, uri, locked, callback);
-    });
+  ContentUnused& unused = contentUnused[uri];
+  unused.lru = contentUnusedLRU.begin();
+  unused.size = content->GetCPUSize() + content->GetGPUSize();
+
+  contentUnusedSize += unused.size;
+}
 
+void Prime::RemoveUnusedContent(const std::string& uri) {
+  auto it = contentUnused.Find(uri);
+  if(!it)
     return;
-  }
 
-  static const std::string _classNameStr("_className");
-  static const std::string nodesStr("nodes");  
-  std::string className;
+  contentUnusedSize -= it.value().size;
+  contentUnusedLRU.erase(it.value().lru);
+  contentUnused.Remove(uri);
+}
 
-  if(IsFormatJSONWithValue(data, dataSize, info, _classNameStr, className)) {
-    json obj;
-    if(IsFormatJSON(data, dataSize, info, obj)) {
-      bool locked = IncContentDataLoading(uri);
+void Prime::EvictUnusedContent() {
+  while(contentUnusedSize > contentCacheBudget && !contentUnusedLRU.empty()) {
+    std::string uri = contentUnusedLRU.back();
+    RemoveUnusedContent(uri);
 
-      refptr<Content> content;
+    contentData.Remove(uri);
 
-      if(locked) {
-        if(className == "Imagemap") {
-          content = new ImagemapContent();
-        }
-        else if(className == "Skinset") {
-          content = new SkinsetContent();
-        }
-        else if(className == "Skeleton") {
-          content = new SkeletonContent();
-        }
-        else if(className == "Model") {
-          content = new ModelContent();
-        }
-        else if(className == "Rig") {
-          content = new RigContent();
-        }
-        else {
-          if(IsFormatJSONWithArray(data, dataSize, info, nodesStr)) {
-            content = new RigContent();
-          }
-        }
+    contentEvictions++;
+  }
+}
 
-#if defined(_DEBUG)
-        if(!content) {
-          dbgprintf("[Warning] Unknown content class: %s\n", className.c_str());
-        }
-#endif
-      }
+void Prime::GetContentByData(const std::string& uri, const std::shared_ptr<const void>& dataBuffer, size_t dataSize, const json& info, const std::function<void (Content*)>& callback) {
+  const void* data = dataBuffer.get();
 
-      new Job([=](Job& job) {
-        if(locked) {
-          if(content) {
-            SetupLoadingContent(content, uri, info);
-            content->Load(obj, info);
-          }
-        }
-        else {
-          WaitForContentDataLoading(uri);
-        }
-      }, [=](Job& job) {
-        OnContentLoadingDone(content, uri, locked, callback);
-      });
-    }
-    else {
-      callback(nullptr);
-    }
+  if(data == nullptr || dataSize == 0) {
+    callback(nullptr);
+    return;
+  }
+
+  // Only prefix checks run here. JSON is parsed once, on the job, and the document goes straight to Load.
+  ContentLoader loader;
+  bool found = FindContentLoader(data, dataSize, info, loader);
+  if(!found && !IsFormatJSONDelimited(data, dataSize)) {
+    callback(nullptr);
+    return;
   }
-  else if(IsFormatPNG(data, dataSize, info)) {
-    bool locked = IncContentDataLoading(uri);
-    refptr<ImagemapContent> content;
-    if(locked) {
-      content = new ImagemapContent();
-    }
 
-    std::string dataCopy((const char*) data, dataSize);
-    new Job([=](Job& job) {
-      if(locked) {
-        if(content) {
-          SetupLoadingContent(content, uri, info);
-          content->Load(dataCopy.c_str(), dataCopy.size(), info);
+  new Job([=](Job& job) {
+    ContentLoadResult result;
 
+    if(found) {
+      result.content = loader.create();
+      if(result.content) {
+        SetupLoadingContent(result.content, uri, info);
+        result.content->Load(dataBuffer.get(), dataSize, info);
+
+        if(loader.pack) {
           PrimePackFormat* ppf = new PrimePackFormat();
           if(ppf) {
-            ppf->InitFromData(dataCopy.c_str(), dataCopy.size());
-            if(ppf->GetError() == PrimePackFormatErrorNone) {
-              if(ppf->GetItemCount() > 0) {
-                ppf->SetContentPath(uri);
-                job.data["ppf"] = ppf;
-              }
+            ppf->InitFromData(dataBuffer, dataSize);
+            if(ppf->GetError() == PrimePackFormatErrorNone && ppf->GetItemCount() > 0) {
+              ppf->SetContentPath(uri);
+              result.ppf = ppf;
             }
             else {
               delete ppf;
@@ -505,202 +650,386 @@ void Prime::GetContentByData(const std::string& uri, const void* data, size_t da
           }
         }
       }
-      else {
-        WaitForContentDataLoading(uri);
-      }
-    }, [=](Job& job) {
-      if(auto it = job.data.find("ppf")) {
-        PrimePackFormat* ppf = it.GetPtr<PrimePackFormat>();
-        contentPPFItems[uri] = new ContentPPF(ppf);
-      }
-      OnContentLoadingDone(content, uri, locked, callback);
-    });
-  }
-  else if(IsFormatGLTF(data, dataSize, info) || IsFormatFBX(data, dataSize, info)) {
-    bool locked = IncContentDataLoading(uri);
-    refptr<ModelContent> content;
-    if(locked) {
-      content = new ModelContent();
     }
-
-    std::string dataCopy((const char*) data, dataSize);
-    new Job([=](Job& job) {
-      if(locked) {
-        if(content) {
-          SetupLoadingContent(content, uri, info);
-          content->Load(dataCopy.c_str(), dataCopy.size(), info);
+    else {
+      json obj;
+      if(obj.parse(dataBuffer.get(), dataSize)) {
+        result.content = CreateContentFromJSON(obj);
+        if(result.content) {
+          SetupLoadingContent(result.content, uri, info);
+          result.content->Load(obj, info);
         }
       }
-      else {
-        WaitForContentDataLoading(uri);
-      }
-    }, [=](Job& job) {
-      OnContentLoadingDone(content, uri, locked, callback);
-    });
-  }
-  else if(IsFormatJPEG(data, dataSize, info)) {
-    bool locked = IncContentDataLoading(uri);
-    refptr<ImagemapContent> content;
-    if(locked) {
-      content = new ImagemapContent();
     }
 
-    std::string dataCopy((const char*) data, dataSize);
-    new Job([=](Job& job) {
-      if(locked) {
-        if(content) {
-          SetupLoadingContent(content, uri, info);
-          content->Load(dataCopy.c_str(), dataCopy.size(), info);
-        }
-      }
-      else {
-        WaitForContentDataLoading(uri);
-      }
-    }, [=](Job& job) {
-      OnContentLoadingDone(content, uri, locked, callback);
-    });
+    job.SetResult(result);
+  }, [=](Job& job) {
+    auto& result = job.GetResult<ContentLoadResult>();
+    refptr<Content> content = result.content;
+
+    if(result.ppf) {
+      AddContentPPF(uri, new ContentPPF(result.ppf));
     }
-  else if(IsFormatOTF(data, dataSize, info)) {
-    bool locked = IncContentDataLoading(uri);
-    refptr<FontContent> content;
-    if(locked) {
-      content = new FontContent();
+
+    // Issued before the callback so the references are in flight by the time the content asks for them.
+    if(content) {
+      PrefetchLoadedContentReferences(uri, content, info);
     }
 
-    std::string dataCopy((const char*) data, dataSize);
-    new Job([=](Job& job) {
-      if(locked) {
-        if(content) {
-          SetupLoadingContent(content, uri, info);
-          content->Load(dataCopy.c_str(), dataCopy.size(), info);
-        }
-      }
-      else {
-        WaitForContentDataLoading(uri);
-      }
-    }, [=](Job& job) {
-      OnContentLoadingDone(content, uri, locked, callback);
-    });
+    callback(content);
+  });
+}
+
+void Prime::AddContentPPF(const std::string& uri, ContentPPF* contentPPF) {
+  if(contentPPFItems.Find(uri)) {
+    // Replacing a pack can expose paths the old one shadowed, so reindex everything.
+    contentPPFItems[uri] = contentPPF;
+    contentPPFPaths.Clear();
+    for(auto it: contentPPFItems) {
+      IndexContentPPF(it.value());
+    }
   }
   else {
-    callback(nullptr);
+    contentPPFItems[uri] = contentPPF;
+    IndexContentPPF(contentPPF);
+  }
+
+  auto ppf = contentPPF->GetPPF();
+  if(ppf->HasItem(ContentReferencesPath)) {
+    size_t dataSize;
+    if(void* data = ppf->GetItemBytes(ContentReferencesPath, &dataSize)) {
+      json references;
+      if(references.parse(data, dataSize)) {
+        AddContentReferences(references, ppf->GetContentPath());
+      }
+      free(data);
+    }
   }
 }
 
-bool Prime::IncContentDataLoading(const std::string& uri) {
-  bool locked = false;
+void Prime::IndexContentPPF(ContentPPF* contentPPF) {
+  auto ppf = contentPPF->GetPPF();
+  const std::string& ppfContentPath = ppf->GetContentPath();
 
-  contentDataMutex->Lock();
-  if(auto it = contentDataLoading.Find(uri)) {
-    auto& value = it.value();
-    value++;
-  }
-  else {
-    if(auto it = contentData.Find(uri)) {
-      auto& value = it.value();
-      contentDataLoading[uri] = 1;
+  std::vector<std::string> paths;
+  ppf->GetItemPaths(paths);
+
+  for(const auto& path: paths) {
+    std::string itemURI = ppfContentPath + path;
+    if(!contentPPFPaths.Find(itemURI)) {
+      contentPPFPaths[itemURI] = contentPPF;
     }
-    else {
-      locked = true;
-      contentDataLoading[uri] = 1;
-      contentDataLoadingLocked[uri] = true;
+  }
+}
+
+ContentPPF* Prime::FindContentPPFItem(const std::string& uri, const json& info, std::string& itemPath, std::string& itemURI) {
+  if(auto it = contentPPFPaths.Find(uri)) {
+    ContentPPF* contentPPF = it.value();
+    itemPath = uri.substr(contentPPF->GetPPF()->GetContentPath().length());
+    itemURI = uri;
+    return contentPPF;
+  }
+
+  // Relative paths resolve against whichever pack their parent came from.
+  if(auto it = info.find("_parentURI")) {
+    std::string parentURI = it.GetString();
+    if(!parentURI.empty()) {
+      for(auto itPPF: contentPPFItems) {
+        auto ppf = itPPF.value()->GetPPF();
+        const std::string& ppfContentPath = ppf->GetContentPath();
+
+        if(StartsWith(parentURI, ppfContentPath) && ppf->HasItem(uri)) {
+          itemPath = uri;
+          itemURI = ppfContentPath + uri;
+          return itPPF.value();
+        }
+      }
     }
   }
-  contentDataMutex->Unlock();
 
-  return locked;
+  return nullptr;
 }
 
-void Prime::DecContentDataLoading(const std::string& uri, bool locked) {
-#if defined(_DEBUG)
-  bool success = false;
-#endif
+std::shared_ptr<const void> Prime::GetContentPPFItemData(ContentPPF* contentPPF, const std::string& itemPath, size_t& dataSize) {
+  auto ppf = contentPPF->GetPPF();
 
-  contentDataMutex->Lock();
-  if(locked) {
-    PrimeAssert(contentDataLoadingLocked.HasKey(uri), "Expected to find content load-lock: uri = %s", uri.c_str());
+  // Stored items alias the pack's buffer, which stays alive for as long as the item data does.
+  if(const void* span = ppf->GetItemSpan(itemPath, &dataSize))
+    return std::shared_ptr<const void>(ppf->GetBuffer(), span);
 
-    contentDataLoadingLocked.Remove(uri);
+  void* data = ppf->GetItemBytes(itemPath, &dataSize);
+  if(!data)
+    return nullptr;
 
-    if(auto it = contentData.Find(uri)) {
-      refptr<Content> content = it.value();
+  return std::shared_ptr<const void>(data, free);
+}
 
-      PrimeAssert(content, "Expected to find content that was just loaded: uri = %s", uri.c_str());
+JobPriority Prime::GetContentPriority(const json& info) {
+  if(auto it = info.find("_priority")) {
+    std::string priority = it.GetString();
+    if(priority == "low") {
+      return JobPriority::Low;
+    }
+    else if(priority == "high") {
+      return JobPriority::High;
+    }
+  }
 
-      size_t loadingCount = 0;
-      if(auto itLoadingCount = contentDataLoading.Find(uri)) {
-        loadingCount = itLoadingCount;
-      }
+  return JobPriority::Normal;
+}
 
-      PrimeAssert(loadingCount > 0, "Expected loading count to be at least 1 for the first content loaded: uri = %s", uri.c_str());
+void Prime::RegisterContentLoader(const std::function<bool (const void*, size_t, const json&)>& match, const std::function<Content* ()>& create, bool pack) {
+  PxRequireMainThread;
 
-      if(loadingCount > 0) {
-        loadingCount--;
-      }
+  ContentLoader loader;
+  loader.match = match;
+  loader.create = create;
+  loader.pack = pack;
+  contentLoaders.Add(loader);
+}
 
-      // Transfer the existing loading count into references.
-      for(size_t i = 0; i < loadingCount; i++) {
-        content->IncRef();
-      }
+bool Prime::FindContentLoader(const void* data, size_t dataSize, const json& info, ContentLoader& loader) {
+  for(const auto& it: contentLoaders) {
+    if(it.match(data, dataSize, info)) {
+      loader = it;
+      return true;
     }
   }
 
-  if(auto it = contentDataLoading.Find(uri)) {
-    auto& value = it.value();
-    if(value > 0) {
-      value--;
-    }
-    if(value == 0) {
-      contentDataLoading.Remove(uri);
-    }
-#if defined(_DEBUG)
-    success = true;
-#endif
+  return false;
+}
+
+Content* Prime::CreateContentFromJSON(const json& data) {
+  static const std::string _classNameStr("_className");
+  static const std::string nodesStr("nodes");
+
+  if(!data.IsObject())
+    return nullptr;
+
+  auto itClassName = data.find(_classNameStr);
+  if(!itClassName || !itClassName.IsString())
+    return nullptr;
+
+  std::string className = itClassName.GetString();
+
+  std::function<Content* ()> create;
+  contentDataMutex->Lock();
+  if(auto it = contentClasses.Find(className)) {
+    create = it.value();
   }
   contentDataMutex->Unlock();
 
+  if(create)
+    return create();
+
+  if(auto it = data.find(nodesStr)) {
+    if(it.IsArray())
+      return new RigContent();
+  }
+
 #if defined(_DEBUG)
-  PrimeAssert(success, "Expected to decrement content data loading value: uri = %s", uri.c_str());
+  dbgprintf("[Warning] Unknown content class: %s\n", className.c_str());
 #endif
+
+  return nullptr;
 }
 
-void Prime::WaitForContentDataLoading(const std::string& uri) {
-  bool loading = true;
-  while(loading) {
-    loading = false;
-    contentDataMutex->Lock();
-    if(auto it = contentDataLoadingLocked.Find(uri)) {
-      loading = true;
-      Thread::Yield();
+bool Prime::IsFormatJSONDelimited(const void* data, size_t dataSize) {
+  if(data == nullptr || dataSize < 2)
+    return false;
+
+  const char* dataStr = (const char*) data;
+
+  char first = dataStr[0];
+  if(first != '{' && first != '[')
+    return false;
+
+  char last = '\0';
+  s64 seekChar = 1;
+  while(seekChar < (s64) dataSize) {
+    last = dataStr[dataSize - seekChar];
+    if(!std::isspace(last)) {
+      break;
     }
-    contentDataMutex->Unlock();
+    seekChar++;
   }
+
+  return last == '}' || last == ']';
 }
 
-void Prime::OnContentLoadingDone(Content* content, const std::string& uri, bool locked, const std::function<void (Content*)>& callback) {
-  if(locked) {
-#if defined(_DEBUG)
-    PrimeAssert(!contentData.HasKey(uri), "Content data already exists: uri = %s", uri.c_str());
-#endif
+void Prime::PrefetchRecordedContentReferences(const std::string& uri, const json& info) {
+  if(!contentPrefetch || contentPrefetched.HasKey(uri))
+    return;
 
-    if(content) {
-      contentData[uri] = content;
+  if(auto it = contentReferences.Find(uri)) {
+    // Copied, since the requests it issues can call back into code that records references.
+    Stack<std::string> references = it.value();
+    PrefetchContentReferences(uri, references, info);
+  }
+}
+
+void Prime::PrefetchLoadedContentReferences(const std::string& uri, Content* content, const json& info) {
+  Stack<std::string> references;
+  content->GetWalkReferences(references);
+  if(references.GetCount() == 0)
+    return;
+
+  contentReferences[uri] = references;
+
+  // Recorded references were already issued alongside the content's own load.
+  if(!contentPrefetch || contentPrefetched.HasKey(uri))
+    return;
+
+  PrefetchContentReferences(uri, references, info);
+}
+
+void Prime::PrefetchContentReferences(const std::string& uri, const Stack<std::string>& references, const json& info) {
+  // References back into the chain that led here are not retained, or a cycle would never be released.
+  json chain;
+  chain.array();
+  if(auto it = info.find("_prefetchChain")) {
+    for(auto& chainURI: it) {
+      chain.append(chainURI.GetString().c_str());
     }
-    DecContentDataLoading(uri, locked);
-    callback(content);
+  }
+  chain.append(uri.c_str());
+
+  json prefetchInfo;
+  prefetchInfo["_parentURI"] = uri.c_str();
+  prefetchInfo["_prefetchChain"] = chain;
+  if(auto it = info.find("_priority")) {
+    prefetchInfo["_priority"] = it.GetString().c_str();
+  }
+
+  contentPrefetched[uri];
+
+  for(const auto& reference: references) {
+    GetContent(reference, prefetchInfo, [=](Content* content) {
+      if(!content)
+        return;
+
+      const std::string& contentURI = content->GetURI();
+      for(auto& chainURI: chain) {
+        if(chainURI.GetString() == contentURI)
+          return;
+      }
+
+      // Held for as long as the parent is cached, so ProcessContentRefs doesn't release them before they're asked for.
+      if(auto it = contentPrefetched.Find(uri)) {
+        it.value().Push(content);
+      }
+    });
+  }
+}
+
+bool Prime::AttachContentLoad(const std::string& uri, const CancelToken& cancel, const std::function<void (Content*)>& callback) {
+  if(auto it = contentData.Find(uri)) {
+    UseCachedContent(uri, it.value(), callback);
+    return true;
+  }
+
+  if(auto it = contentLoads.Find(uri)) {
+    // A cancelled load has nothing left to give, so a new request starts over.
+    if(it.value().cancel.IsCancelled()) {
+      CancelToken loadCancel = it.value().cancel;
+      FinishContentLoad(uri, loadCancel, nullptr);
+      return false;
+    }
+
+    contentJoins++;
+    AddContentLoadRequest(uri, cancel, callback);
+    return true;
+  }
+
+  return false;
+}
+
+CancelToken Prime::StartContentLoad(const std::string& uri, const json& info, const CancelToken& cancel, const std::function<void (Content*)>& callback) {
+  contentMisses++;
+
+  CancelToken loadCancel = CancelToken::Create();
+  contentLoads[uri].cancel = loadCancel;
+
+  AddContentLoadRequest(uri, cancel, callback);
+
+  // After the load is registered, so a reference back to this URI joins it.
+  PrefetchRecordedContentReferences(uri, info);
+
+  return loadCancel;
+}
+
+void Prime::AddContentLoadRequest(const std::string& uri, const CancelToken& cancel, const std::function<void (Content*)>& callback) {
+  ContentLoadRequest request;
+  request.callback = callback;
+  request.cancel = cancel;
+
+  if(cancel.IsValid()) {
+    // OnCancel runs on whichever thread cancels, so the check is handed back to the main thread.
+    request.cancelID = cancel.OnCancel([=]() {
+      new Job(nullptr, [=](Job& job) {
+        CancelAbandonedContentLoad(uri);
+      });
+    });
+  }
+
+  contentLoads[uri].requests.Add(request);
+}
+
+void Prime::CancelAbandonedContentLoad(const std::string& uri) {
+  auto it = contentLoads.Find(uri);
+  if(!it)
+    return;
+
+  ContentLoad& load = it.value();
+  for(const auto& request: load.requests) {
+    if(!request.cancel.IsCancelled())
+      return;
+  }
+
+  // Finished now rather than when the cancelled load comes back, so a later request for the URI starts a fresh one.
+  CancelToken loadCancel = load.cancel;
+  loadCancel.Cancel();
+  FinishContentLoad(uri, loadCancel, nullptr);
+}
+
+void Prime::FinishContentLoad(const std::string& uri, const CancelToken& loadCancel, Content* content) {
+  refptr<Content> loadedContent = content;
+
+  // A load that was abandoned may already have been replaced by another for the same URI.
+  auto it = contentLoads.Find(uri);
+  if(!it || it.value().cancel != loadCancel)
+    return;
+
+  Stack<ContentLoadRequest> requests = it.value().requests;
+  contentLoads.Remove(uri);
+
+  if(loadedContent) {
+    contentData[uri] = loadedContent;
   }
   else {
-    if(auto it = contentData.Find(uri)) {
-      refptr<Content> foundContent = it.value();
-      DecContentDataLoading(uri, locked);
-      callback(foundContent);
+    // A content that fails to load has nothing to hold its references for.
+    contentPrefetched.Remove(uri);
+  }
+
+  for(auto& request: requests) {
+    if(request.cancelID != 0) {
+      request.cancel.RemoveOnCancel(request.cancelID);
     }
-    else {
-#if defined(_DEBUG)
-      //PrimeAssert(false, "Expected to find content data after waiting for loading: uri = %s", uri.c_str());
-#endif
 
-      callback(nullptr);
+    request.callback(request.cancel.IsCancelled() ? nullptr : content);
+  }
+
+  // Nothing may have kept a reference, in which case no release will ever be seen for it.
+  if(loadedContent) {
+    OnContentReleased(loadedContent);
+  }
+}
+
+void Prime::OnContentReleased(Content* content) {
+  const std::string& uri = content->GetURI();
+  if(auto it = contentData.Find(uri)) {
+    if((Content*) it.value() == content) {
+      contentReleased[uri] = GetSystemTime();
     }
   }
 }
@@ -715,32 +1044,12 @@ bool Prime::IsFormatJSON(const void* data, size_t dataSize, const json& info) {
 }
 
 bool Prime::IsFormatJSON(const void* data, size_t dataSize, const json& info, json& output) {
-  if(data == nullptr || dataSize < 2)
+  if(!IsFormatJSONDelimited(data, dataSize))
     return false;
 
   bool result;
-  char first = '\0';
-  char last = '\0';
   const char* dataStr = (const char*) data;
 
-  first = dataStr[0];
-  if(first != '{' && first != '[') {
-    return false;
-  }
-
-  s64 seekChar = 1;
-  while(seekChar < (s64) dataSize) {
-    last = dataStr[dataSize - seekChar];
-    if(!std::isspace(last)) {
-      break;
-    }
-    seekChar++;
-  }
-
-  if(last != '}' && last != ']') {
-    return false;
-  }
-
   result = false;
   if(output.parse(data, dataSize)) {
     result = true;
@@ -753,32 +1062,12 @@ bool Prime::IsFormatJSON(const void* data, size_t dataSize, const json& info, js
 }
 
 bool Prime::IsFormatJSONWithValue(const void* data, size_t dataSize, const json& info, const std::string& key, std::string& value) {
-  if(data == nullptr || dataSize < 2)
+  if(!IsFormatJSONDelimited(data, dataSize))
     return false;
 
   bool result;
-  char first = '\0';
-  char last = '\0';
   const char* dataStr = (const char*) data;
 
-  first = dataStr[0];
-  if(first != '{' && first != '[') {
-    return false;
-  }
-
-  s64 seekChar = 1;
-  while(seekChar < (s64) dataSize) {
-    last = dataStr[dataSize - seekChar];
-    if(!std::isspace(last)) {
-      break;
-    }
-    seekChar++;
-  }
-
-  if(last != '}' && last != ']') {
-    return false;
-  }
-
   result = false;
   s32 tokenCount;
   jsmn_parser parser;
@@ -827,32 +1116,12 @@ bool Prime::IsFormatJSONWithValue(const void* data, size_t dataSize, const json&
 }
 
 bool Prime::IsFormatJSONWithArray(const void* data, size_t dataSize, const json& info, const std::string& key) {
-  if(data == nullptr || dataSize < 2)
+  if(!IsFormatJSONDelimited(data, dataSize))
     return false;
 
   bool result;
-  char first = '\0';
-  char last = '\0';
   const char* dataStr = (const char*) data;
 
-  first = dataStr[0];
-  if(first != '{' && first != '[') {
-    return false;
-  }
-
-  s64 seekChar = 1;
-  while(seekChar < (s64) dataSize) {
-    last = dataStr[dataSize - seekChar];
-    if(!std::isspace(last)) {
-      break;
-    }
-    seekChar++;
-  }
-
-  if(last != '}' && last != ']') {
-    return false;
-  }
-
   result = false;
   s32 tokenCount;
   jsmn_parser parser;
@@ -901,10 +1170,12 @@ bool Prime::IsFormatPNG(const void* data, size_t dataSize, const json& info) {
 }
 
 bool Prime::IsFormatJPEG(const void* data, size_t dataSize, const json& info) {
-  if(data == nullptr)
+  if(data == nullptr || dataSize < 3)
     return false;
 
-  LockSetjmpMutex();
+  // Every JPEG starts with an SOI marker followed by another marker, so skip libjpeg for anything else.
+  if(memcmp(data, "\xFF\xD8\xFF", 3) != 0)
+    return false;
 
   struct jpeg_decompress_struct jpegInfo;
   jpegErrorManager jerr;
@@ -917,7 +1188,6 @@ bool Prime::IsFormatJPEG(const void* data, size_t dataSize, const json& info) {
   if(setjmp(jerr.setjmp_buffer)) {
     // If we get here, the JPEG code has signaled an error.
     jpeg_destroy_decompress(&jpegInfo);
-    UnlockSetjmpMutex();
     return false;
   }
 
@@ -925,8 +1195,6 @@ bool Prime::IsFormatJPEG(const void* data, size_t dataSize, const json& info) {
   int result = jpeg_read_header(&jpegInfo, FALSE);
   jpeg_destroy_decompress(&jpegInfo);
 
-  UnlockSetjmpMutex();
-
   return result == JPEG_HEADER_OK;
 }
 
@@ -1001,6 +1269,6 @@ bool Prime::IsFormatOTF(const void* data, size_t dataSize, const json& info) {
 
 static void jpegErrorExit(j_common_ptr cinfo) {
   jpegErrorManager* myerr = (jpegErrorManager*) cinfo->err;
-  (*(cinfo->err->format_message)) (cinfo, jpegLastErrorMsg);
+  (*(cinfo->err->format_message)) (cinfo, myerr->lastErrorMsg);
   longjmp(myerr->setjmp_buffer, 1);
 }
@@ -0,0 +1,730 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__) || defined(__APPLE__)
+
+#include <Prime/System/posix/FileReadQueue.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && !defined(PrimeFileReadQueueNoIOUring)
+#define PrimeFileReadQueueIOUring 1
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums
+////////////////////////////////////////////////////////////////////////////////
+
+typedef enum {
+  FileReadTypeRead = 0,
+  FileReadTypeMap,
+  FileReadTypeReadAhead,
+} FileReadType;
+
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+// Marks a request whose descriptor has been claimed by the batch reading it.
+#define FileReadRequestTaken (-2)
+
+// Single reads are capped well below the 2 GB limit some kernels put on them.
+#define FileReadChunkSize (1024 * 1024 * 1024)
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace Prime {
+
+class FileReadRequest {
+public:
+
+  std::string path;
+  FileReadType type;
+  JobPriority priority;
+  std::function<void (void*, size_t)> readCallback;
+  std::function<void (const std::shared_ptr<const void>&, size_t)> mapCallback;
+  std::chrono::steady_clock::time_point queuedTime;
+
+  // Opened early by read-ahead hints, then claimed by whichever batch reads the file.
+  std::atomic<int> fd;
+  bool hinted;
+
+  void* data;
+  std::shared_ptr<const void> mapping;
+  size_t size;
+  size_t readSize;
+  bool failed;
+
+public:
+
+  FileReadRequest(const std::string& path, FileReadType type, JobPriority priority):
+  path(path),
+  type(type),
+  priority(priority),
+  queuedTime(std::chrono::steady_clock::now()),
+  fd(-1),
+  hinted(false),
+  data(nullptr),
+  size(0),
+  readSize(0),
+  failed(false) {
+
+  }
+
+  ~FileReadRequest() {
+    int requestFD = fd.exchange(FileReadRequestTaken);
+    if(requestFD >= 0) {
+      close(requestFD);
+    }
+
+    if(data) {
+      free(data);
+    }
+  }
+
+};
+
+};
+
+#if defined(PrimeFileReadQueueIOUring)
+
+namespace Prime {
+
+// A minimal io_uring wrapper over the raw syscalls, one per IO worker thread.
+class FileReadRing {
+private:
+
+  int fd;
+  bool initialized;
+  unsigned entries;
+
+  void* sqRing;
+  size_t sqRingSize;
+  void* cqRing;
+  size_t cqRingSize;
+  io_uring_sqe* sqes;
+  size_t sqesSize;
+
+  unsigned* sqHead;
+  unsigned* sqTail;
+  unsigned* sqMask;
+  unsigned* sqArray;
+  unsigned* cqHead;
+  unsigned* cqTail;
+  unsigned* cqMask;
+  io_uring_cqe* cqes;
+
+public:
+
+  unsigned GetEntries() const {return entries;}
+
+public:
+
+  FileReadRing():
+  fd(-1),
+  initialized(false),
+  entries(0),
+  sqRing(MAP_FAILED),
+  sqRingSize(0),
+  cqRing(MAP_FAILED),
+  cqRingSize(0),
+  sqes((io_uring_sqe*) MAP_FAILED),
+  sqesSize(0) {
+
+  }
+
+  ~FileReadRing() {
+    Shutdown();
+  }
+
+public:
+
+  bool Init(unsigned requestedEntries) {
+    if(initialized)
+      return fd >= 0;
+
+    initialized = true;
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // Containers and older kernels refuse io_uring; callers fall back to pread.
+    fd = (int) syscall(__NR_io_uring_setup, requestedEntries, &params);
+    if(fd < 0)
+      return false;
+
+    entries = params.sq_entries;
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+      sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(sqRing == MAP_FAILED) {
+      Shutdown();
+      return false;
+    }
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+      cqRing = sqRing;
+    }
+    else {
+      cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if(cqRing == MAP_FAILED) {
+        Shutdown();
+        return false;
+      }
+    }
+
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    sqes = (io_uring_sqe*) mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+      Shutdown();
+      return false;
+    }
+
+    uint8_t* sq = (uint8_t*) sqRing;
+    sqHead = (unsigned*) (sq + params.sq_off.head);
+    sqTail = (unsigned*) (sq + params.sq_off.tail);
+    sqMask = (unsigned*) (sq + params.sq_off.ring_mask);
+    sqArray = (unsigned*) (sq + params.sq_off.array);
+
+    uint8_t* cq = (uint8_t*) cqRing;
+    cqHead = (unsigned*) (cq + params.cq_off.head);
+    cqTail = (unsigned*) (cq + params.cq_off.tail);
+    cqMask = (unsigned*) (cq + params.cq_off.ring_mask);
+    cqes = (io_uring_cqe*) (cq + params.cq_off.cqes);
+
+    return true;
+  }
+
+  void Shutdown() {
+    if(sqes != MAP_FAILED) {
+      munmap(sqes, sqesSize);
+      sqes = (io_uring_sqe*) MAP_FAILED;
+    }
+
+    if(cqRing != MAP_FAILED && cqRing != sqRing) {
+      munmap(cqRing, cqRingSize);
+    }
+    cqRing = MAP_FAILED;
+
+    if(sqRing != MAP_FAILED) {
+      munmap(sqRing, sqRingSize);
+      sqRing = MAP_FAILED;
+    }
+
+    if(fd >= 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+
+  void PrepareRead(int fileFD, void* p, unsigned size, uint64_t offset, uint64_t userData) {
+    // Only this thread produces submissions, so the tail needs no atomic read-modify-write.
+    unsigned tail = *sqTail;
+    unsigned index = tail & *sqMask;
+
+    io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fileFD;
+    sqe->addr = (uint64_t) (uintptr_t) p;
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->user_data = userData;
+
+    sqArray[index] = index;
+    __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+  }
+
+  bool Submit(unsigned submitCount, unsigned waitCount) {
+    while(true) {
+      int result = (int) syscall(__NR_io_uring_enter, fd, submitCount, waitCount, waitCount > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+      if(result >= 0)
+        return true;
+
+      if(errno != EINTR)
+        return false;
+
+      // Submissions taken before the interruption are not submitted again.
+      submitCount = 0;
+    }
+  }
+
+  bool PeekCompletion(uint64_t& userData, int& result) {
+    unsigned head = *cqHead;
+    if(head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+      return false;
+
+    const io_uring_cqe* cqe = &cqes[head & *cqMask];
+    userData = cqe->user_data;
+    result = cqe->res;
+
+    __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+};
+
+};
+
+static thread_local FileReadRing fileReadRing;
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static void HintFileReadAhead(int fd) {
+#if defined(POSIX_FADV_WILLNEED)
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+  struct stat st;
+  if(fstat(fd, &st) == 0 && st.st_size > 0) {
+    struct radvisory advisory;
+    advisory.ra_offset = 0;
+    advisory.ra_count = (int) std::min<off_t>(st.st_size, INT_MAX);
+    fcntl(fd, F_RDADVISE, &advisory);
+  }
+#endif
+}
+
+static int OpenFileForRead(const std::string& path) {
+  int flags = O_RDONLY;
+#if defined(O_CLOEXEC)
+  flags |= O_CLOEXEC;
+#endif
+
+  int fd;
+  do {
+    fd = open(path.c_str(), flags);
+  }
+  while(fd < 0 && errno == EINTR);
+
+  return fd;
+}
+
+static void ReadFileRemaining(FileReadRequest& request, int fd) {
+  uint8_t* p = (uint8_t*) request.data;
+  while(request.readSize < request.size) {
+    size_t bytesToRead = std::min<size_t>(request.size - request.readSize, FileReadChunkSize);
+    ssize_t bytesRead = pread(fd, p + request.readSize, bytesToRead, (off_t) request.readSize);
+    if(bytesRead > 0) {
+      request.readSize += (size_t) bytesRead;
+    }
+    else if(bytesRead < 0 && errno == EINTR) {
+      continue;
+    }
+    else {
+      // A file that shrank since fstat is returned as far as it could be read.
+      if(bytesRead < 0) {
+        request.failed = true;
+      }
+      break;
+    }
+  }
+}
+
+#if defined(PrimeFileReadQueueIOUring)
+
+static bool ReadFilesWithRing(std::vector<std::pair<FileReadRequest*, int>>& reads) {
+  if(!fileReadRing.Init(PrimeFileReadQueueMaxBatchSize))
+    return false;
+
+  size_t next = 0;
+  size_t inFlight = 0;
+  unsigned entries = fileReadRing.GetEntries();
+  bool unsupported = false;
+
+  // One read per file is in flight at a time; short reads queue the remainder behind the rest.
+  std::vector<size_t> pending;
+  for(size_t i = 0; i < reads.size(); i++) {
+    pending.push_back(i);
+  }
+
+  while((next < pending.size() && !unsupported) || inFlight > 0) {
+    unsigned submitCount = 0;
+    while(next < pending.size() && inFlight < entries && !unsupported) {
+      size_t index = pending[next++];
+      FileReadRequest* request = reads[index].first;
+      unsigned size = (unsigned) std::min<size_t>(request->size - request->readSize, FileReadChunkSize);
+      fileReadRing.PrepareRead(reads[index].second, (uint8_t*) request->data + request->readSize, size, request->readSize, index);
+      submitCount++;
+      inFlight++;
+    }
+
+    if(!fileReadRing.Submit(submitCount, 1)) {
+      // Reads already submitted still complete into request buffers, so wait them out before falling back.
+      if(inFlight > submitCount) {
+        fileReadRing.Submit(0, (unsigned) (inFlight - submitCount));
+      }
+
+      fileReadRing.Shutdown();
+      return false;
+    }
+
+    uint64_t userData;
+    int result;
+    while(fileReadRing.PeekCompletion(userData, result)) {
+      inFlight--;
+
+      FileReadRequest* request = reads[(size_t) userData].first;
+      if(result > 0) {
+        request->readSize += (size_t) result;
+        if(request->readSize < request->size) {
+          pending.push_back((size_t) userData);
+        }
+      }
+      else if(result == -EINTR || result == -EAGAIN) {
+        pending.push_back((size_t) userData);
+      }
+      else if(result == -EINVAL || result == -EOPNOTSUPP) {
+        // Kernels before 5.6 have io_uring without IORING_OP_READ.
+        unsupported = true;
+      }
+      else if(result < 0) {
+        request->failed = true;
+      }
+    }
+  }
+
+  if(unsupported) {
+    fileReadRing.Shutdown();
+    return false;
+  }
+
+  return true;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+FileReadQueue::FileReadQueue(size_t maxBatches, size_t maxBatchSize, size_t mapThreshold, size_t readAheadCount):
+mutex("Prime::FileReadQueue mutex"),
+activeBatches(0),
+maxBatches(std::max<size_t>(maxBatches, 1)),
+maxBatchSize(std::max<size_t>(maxBatchSize, 1)),
+mapThreshold(mapThreshold),
+readAheadCount(readAheadCount),
+batches(0),
+ringBatches(0),
+readAheads(0),
+bytesRead(0),
+bytesMapped(0) {
+  for(size_t i = 0; i < 3; i++) {
+    started[i] = 0;
+    maxWaitTime[i] = 0.0;
+  }
+}
+
+FileReadQueue::~FileReadQueue() {
+
+}
+
+void FileReadQueue::Read(const std::string& path, JobPriority priority, const std::function<void (void*, size_t)>& callback) {
+  auto request = std::make_shared<FileReadRequest>(path, FileReadTypeRead, priority);
+  request->readCallback = callback;
+  Enqueue(request);
+}
+
+void FileReadQueue::Map(const std::string& path, JobPriority priority, const std::function<void (const std::shared_ptr<const void>&, size_t)>& callback) {
+  auto request = std::make_shared<FileReadRequest>(path, FileReadTypeMap, priority);
+  request->mapCallback = callback;
+  Enqueue(request);
+}
+
+void FileReadQueue::ReadAhead(const std::string& path) {
+  Enqueue(std::make_shared<FileReadRequest>(path, FileReadTypeReadAhead, JobPriority::Low));
+}
+
+json FileReadQueue::GetStats() {
+  static const char* priorityNames[] = {"low", "normal", "high"};
+
+  json stats;
+
+  mutex.Lock();
+  stats["activeBatches"] = activeBatches;
+  stats["batches"] = batches;
+  stats["ringBatches"] = ringBatches;
+  stats["readAheads"] = readAheads;
+  stats["bytesRead"] = bytesRead;
+  stats["bytesMapped"] = bytesMapped;
+
+  for(size_t i = 0; i < 3; i++) {
+    json priorityStats;
+    priorityStats["queued"] = queues[i].size();
+    priorityStats["started"] = started[i];
+    priorityStats["maxWaitTime"] = maxWaitTime[i];
+    stats[priorityNames[i]] = priorityStats;
+  }
+  mutex.Unlock();
+
+  return stats;
+}
+
+void FileReadQueue::Enqueue(const std::shared_ptr<FileReadRequest>& request) {
+  mutex.Lock();
+  queues[(size_t) request->priority].push_back(request);
+  mutex.Unlock();
+
+  Dispatch();
+}
+
+void FileReadQueue::Dispatch() {
+  std::vector<std::shared_ptr<std::vector<std::shared_ptr<FileReadRequest>>>> startBatches;
+
+  mutex.Lock();
+  while(activeBatches < maxBatches) {
+    auto batch = std::make_shared<std::vector<std::shared_ptr<FileReadRequest>>>();
+
+    for(size_t i = 3; i-- > 0 && batch->size() < maxBatchSize;) {
+      auto& queue = queues[i];
+      while(!queue.empty() && batch->size() < maxBatchSize) {
+        auto request = queue.front();
+        queue.pop_front();
+
+        double wait = std::chrono::duration<double>(std::chrono::steady_clock::now() - request->queuedTime).count();
+        started[i]++;
+        maxWaitTime[i] = std::max(maxWaitTime[i], wait);
+
+        batch->push_back(request);
+      }
+    }
+
+    if(batch->empty())
+      break;
+
+    activeBatches++;
+    batches++;
+    startBatches.push_back(batch);
+  }
+  mutex.Unlock();
+
+  for(auto& batch: startBatches) {
+    StartBatch(batch);
+  }
+}
+
+void FileReadQueue::StartBatch(const std::shared_ptr<std::vector<std::shared_ptr<FileReadRequest>>>& batch) {
+  // The batch slot is given back once the reads are done, without waiting for the responses on the main thread.
+  new Job([this, batch](Job& job) {
+    ReadBatch(*batch);
+
+    mutex.Lock();
+    activeBatches--;
+    mutex.Unlock();
+
+    HintQueued();
+    Dispatch();
+  }, [batch](Job& job) {
+    for(auto& request: *batch) {
+      if(request->type == FileReadTypeRead) {
+        void* data = request->data;
+        size_t size = request->readSize;
+        request->data = nullptr;
+
+        if(request->failed && data) {
+          free(data);
+          data = nullptr;
+          size = 0;
+        }
+
+        // The callback owns the data, as with ReadFile.
+        request->readCallback(data, size);
+      }
+      else if(request->type == FileReadTypeMap) {
+        request->mapCallback(request->mapping, request->mapping ? request->size : 0);
+      }
+    }
+  }, JobType::IO);
+}
+
+void FileReadQueue::ReadBatch(std::vector<std::shared_ptr<FileReadRequest>>& batch) {
+  std::vector<std::pair<FileReadRequest*, int>> reads;
+  uint64_t batchBytesRead = 0;
+  uint64_t batchBytesMapped = 0;
+  size_t batchReadAheads = 0;
+
+  for(auto& request: batch) {
+    int fd = request->fd.exchange(FileReadRequestTaken);
+    if(fd < 0) {
+      fd = OpenFileForRead(request->path);
+    }
+
+    if(fd < 0) {
+      request->failed = true;
+      continue;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+      request->failed = true;
+      close(fd);
+      continue;
+    }
+
+    request->size = (size_t) st.st_size;
+
+    if(request->type == FileReadTypeReadAhead) {
+      HintFileReadAhead(fd);
+      close(fd);
+      batchReadAheads++;
+      continue;
+    }
+
+    if(request->type == FileReadTypeMap && request->size >= mapThreshold && request->size > 0) {
+      void* view = mmap(nullptr, request->size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(view != MAP_FAILED) {
+#if defined(MADV_WILLNEED)
+        madvise(view, request->size, MADV_WILLNEED);
+#endif
+        size_t size = request->size;
+        request->mapping = std::shared_ptr<const void>(view, [size](const void* p) {
+          munmap((void*) p, size);
+        });
+
+        batchBytesMapped += size;
+        close(fd);
+        continue;
+      }
+    }
+
+    request->data = malloc(std::max<size_t>(request->size, 1));
+    if(!request->data) {
+      request->failed = true;
+      close(fd);
+      continue;
+    }
+
+    reads.push_back({request.get(), fd});
+  }
+
+  bool readWithRing = false;
+
+#if defined(PrimeFileReadQueueIOUring)
+  if(!reads.empty()) {
+    readWithRing = ReadFilesWithRing(reads);
+  }
+#endif
+
+  if(!readWithRing) {
+    // Every file in the batch starts reading into the page cache before the first pread blocks.
+    for(auto& read: reads) {
+      HintFileReadAhead(read.second);
+    }
+
+    for(auto& read: reads) {
+      ReadFileRemaining(*read.first, read.second);
+    }
+  }
+
+  for(auto& read: reads) {
+    FileReadRequest* request = read.first;
+    close(read.second);
+
+    batchBytesRead += request->readSize;
+
+    if(request->type == FileReadTypeMap && !request->failed) {
+      void* data = request->data;
+      request->data = nullptr;
+      request->size = request->readSize;
+      request->mapping = std::shared_ptr<const void>(data, free);
+    }
+  }
+
+  mutex.Lock();
+  if(readWithRing) {
+    ringBatches++;
+  }
+  readAheads += batchReadAheads;
+  bytesRead += batchBytesRead;
+  bytesMapped += batchBytesMapped;
+  mutex.Unlock();
+}
+
+void FileReadQueue::HintQueued() {
+  if(readAheadCount == 0)
+    return;
+
+  std::vector<std::shared_ptr<FileReadRequest>> requests;
+
+  mutex.Lock();
+  for(size_t i = 3; i-- > 0 && requests.size() < readAheadCount;) {
+    for(auto& request: queues[i]) {
+      if(requests.size() >= readAheadCount)
+        break;
+
+      if(!request->hinted && request->type != FileReadTypeReadAhead) {
+        request->hinted = true;
+        requests.push_back(request);
+      }
+    }
+  }
+  mutex.Unlock();
+
+  // The descriptor is handed to the request, so reading it later costs no second open.
+  for(auto& request: requests) {
+    int fd = OpenFileForRead(request->path);
+    if(fd < 0)
+      continue;
+
+    HintFileReadAhead(fd);
+
+    int expected = -1;
+    if(!request->fd.compare_exchange_strong(expected, fd)) {
+      close(fd);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__) || defined(__APPLE__)
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Prime/Config.h>
+#include <Prime/System/posix/FileReadQueue.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string GetFullPath(const std::string& path);
+static FileReadQueue& GetFileReadQueue();
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+void* Prime::ReadFile(const std::string& path, size_t* size) {
+  if(size) {
+    *size = 0;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t fileSize = (size_t) st.st_size;
+  size_t resultSize = 0;
+
+  u8* result = (u8*) malloc(std::max<size_t>(fileSize, 1));
+  if(result) {
+    while(resultSize < fileSize) {
+      ssize_t bytesRead = read(fd, result + resultSize, fileSize - resultSize);
+      if(bytesRead > 0) {
+        resultSize += (size_t) bytesRead;
+      }
+      else if(bytesRead < 0 && errno == EINTR) {
+        continue;
+      }
+      else {
+        break;
+      }
+    }
+  }
+
+  close(fd);
+
+  if(size) {
+    *size = resultSize;
+  }
+
+  return result;
+}
+
+void Prime::ReadFile(const std::string& path, const std::function<void (void*, size_t)>& callback, JobPriority priority) {
+  if(path.empty()) {
+    callback(nullptr, 0);
+    return;
+  }
+
+  GetFileReadQueue().Read(GetFullPath(path), priority, callback);
+}
+
+std::shared_ptr<const void> Prime::MapFile(const std::string& path, size_t* size) {
+  if(size) {
+    *size = 0;
+  }
+
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if(fd < 0)
+    return nullptr;
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t fileSize = (size_t) st.st_size;
+
+  // Small files cost less to read than to map and fault in.
+  void* view = MAP_FAILED;
+  if(fileSize >= PrimeFileReadQueueMapThreshold) {
+    view = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+
+  close(fd);
+
+  if(view == MAP_FAILED) {
+    size_t readSize = 0;
+    void* data = ReadFile(path, &readSize);
+    if(!data)
+      return nullptr;
+
+    if(size) {
+      *size = readSize;
+    }
+
+    return std::shared_ptr<const void>(data, free);
+  }
+
+  if(size) {
+    *size = fileSize;
+  }
+
+  return std::shared_ptr<const void>(view, [fileSize](const void* p) {
+    munmap((void*) p, fileSize);
+  });
+}
+
+void Prime::MapFile(const std::string& path, const std::function<void (const std::shared_ptr<const void>&, size_t)>& callback, JobPriority priority) {
+  if(path.empty()) {
+    callback(nullptr, 0);
+    return;
+  }
+
+  GetFileReadQueue().Map(GetFullPath(path), priority, callback);
+}
+
+void Prime::ReadFileAhead(const std::string& path) {
+  if(path.empty())
+    return;
+
+  GetFileReadQueue().ReadAhead(GetFullPath(path));
+}
+
+std::string GetFullPath(const std::string& path) {
+  // Matches the Windows backend, which reads paths from the folder tree below the working directory.
+  if(StartsWith(path, "/")) {
+    return path.substr(1);
+  }
+
+  return path;
+}
+
+FileReadQueue& GetFileReadQueue() {
+  static FileReadQueue fileReadQueue(PrimeFileReadQueueMaxBatches, PrimeFileReadQueueMaxBatchSize, PrimeFileReadQueueMapThreshold, PrimeFileReadQueueReadAheadCount);
+  return fileReadQueue;
+}
+
+#endif
@@ -40,6 +40,12 @@ using namespace Prime;
 // Functions
 ////////////////////////////////////////////////////////////////////////////////
 
+static std::string GetFullPath(const std::string& path);
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
 f64 Prime::GetSystemTime() {
 #if defined(PrimeTargetOpenGL)
   return glfwGetTime();
@@ -89,12 +95,137 @@ void* Prime::ReadFile(const std::string& path, size_t* size) {
   return result;
 }
 
-void Prime::ReadFile(const std::string& path, const std::function<void (void*, size_t)>& callback) {
+void Prime::ReadFile(const std::string& path, const std::function<void (void*, size_t)>& callback, JobPriority priority) {
+  if(path.empty()) {
+    callback(nullptr, 0);
+    return;
+  }
+
+  std::string fullPath = GetFullPath(path);
+
+  new Job([=](Job& cb) {
+    size_t size = 0;
+    void* result = ReadFile(fullPath.c_str(), &size);
+    cb.SetResult(std::make_pair(result, size));
+  }, [=](Job& cb) {
+    auto& result = cb.GetResult<std::pair<void*, size_t>>();
+    callback(result.first, result.second);
+  }, priority, JobType::IO);
+}
+
+std::shared_ptr<const void> Prime::MapFile(const std::string& path, size_t* size) {
+  if(size) {
+    *size = 0;
+  }
+
+  const void* view = nullptr;
+  LARGE_INTEGER fileSize;
+  fileSize.QuadPart = 0;
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+    return nullptr;
+
+  if(!GetFileSizeEx(file, &fileSize)) {
+    CloseHandle(file);
+    return nullptr;
+  }
+
+  // Small files cost less to read than to map and fault in.
+  if(fileSize.QuadPart < PrimeMapFileThreshold) {
+    DWORD dataSize = (DWORD) fileSize.QuadPart;
+    void* data = malloc(dataSize);
+    DWORD bytesRead = 0;
+    if(data && dataSize > 0 && !(::ReadFile(file, data, dataSize, &bytesRead, nullptr) && bytesRead == dataSize)) {
+      PrimeSafeFree(data);
+    }
+
+    CloseHandle(file);
+
+    if(!data)
+      return nullptr;
+
+    if(size) {
+      *size = dataSize;
+    }
+
+    return std::shared_ptr<const void>(data, free);
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(mapping) {
+    // The view keeps the mapping alive, so both handles can be closed right away.
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+  }
+
+  CloseHandle(file);
+
+  if(!view) {
+    size_t readSize = 0;
+    void* data = ReadFile(path, &readSize);
+    if(!data)
+      return nullptr;
+
+    if(size) {
+      *size = readSize;
+    }
+
+    return std::shared_ptr<const void>(data, free);
+  }
+
+  if(size) {
+    *size = (size_t) fileSize.QuadPart;
+  }
+
+  return std::shared_ptr<const void>(view, [](const void* p) {
+    UnmapViewOfFile(p);
+  });
+}
+
+void Prime::MapFile(const std::string& path, const std::function<void (const std::shared_ptr<const void>&, size_t)>& callback, JobPriority priority) {
   if(path.empty()) {
     callback(nullptr, 0);
     return;
   }
 
+  std::string fullPath = GetFullPath(path);
+
+  new Job([=](Job& cb) {
+    size_t size = 0;
+    std::shared_ptr<const void> result = MapFile(fullPath, &size);
+    cb.SetResult(std::make_pair(result, size));
+  }, [=](Job& cb) {
+    auto& result = cb.GetResult<std::pair<std::shared_ptr<const void>, size_t>>();
+    callback(result.first, result.second);
+  }, priority, JobType::IO);
+}
+
+void Prime::ReadFileAhead(const std::string& path) {
+  if(path.empty())
+    return;
+
+  std::string fullPath = GetFullPath(path);
+
+  // Reading through the file with sequential scan warms the system cache for the real read.
+  new Job([=](Job& cb) {
+    HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+      return;
+
+    static thread_local u8 buffer[256 * 1024];
+    DWORD bytesRead = 0;
+    do {
+      if(!::ReadFile(file, buffer, sizeof(buffer), &bytesRead, nullptr))
+        break;
+    }
+    while(bytesRead > 0);
+
+    CloseHandle(file);
+  }, nullptr, JobPriority::Low, JobType::IO);
+}
+
+std::string GetFullPath(const std::string& path) {
   // Force paths to be read from folder tree below the running exe file.
   CHAR cwd[8 * 1024];
   GetCurrentDirectoryA(sizeof(cwd) - 1, cwd);
@@ -108,16 +239,7 @@ void Prime::ReadFile(const std::string& path, const std::function<void (void*, s
     fullPath += "/" + path;
   }
 
-  new Job([=](Job& cb) {
-    size_t size;
-    void* result = ReadFile(fullPath.c_str(), &size);
-    cb.data["result"] = result;
-    cb.data["size"] = size;
-  }, [=](Job& cb) {
-    void* result = cb.data["result"].GetVoidPtr();
-    size_t size = cb.data["size"].GetSizeT();
-    callback(result, size);
-  });
+  return fullPath;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
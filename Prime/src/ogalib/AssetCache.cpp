@@ -0,0 +1,178 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/ogalib.h>
+#include <ogalib/AssetCache.h>
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+AssetCache::AssetCache(size_t maxSize, size_t shardCount):
+maxSize(maxSize),
+size(0),
+count(0),
+hits(0),
+misses(0),
+evictions(0) {
+  if(shardCount == 0) {
+    shardCount = 1;
+  }
+
+  shards.reserve(shardCount);
+  for(size_t i = 0; i < shardCount; i++) {
+    shards.push_back(new Shard());
+  }
+}
+
+AssetCache::~AssetCache() {
+  for(auto shard: shards) {
+    delete shard;
+  }
+}
+
+bool AssetCache::Get(const std::string& key, AssetCacheItem& item) {
+  Shard& shard = GetShard(key);
+
+  shard.mutex.Lock();
+
+  auto it = shard.entries.find(key);
+  if(it == shard.entries.end()) {
+    shard.mutex.Unlock();
+    misses++;
+    return false;
+  }
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+  item = it->second.item;
+
+  shard.mutex.Unlock();
+
+  hits++;
+
+  return true;
+}
+
+void AssetCache::Set(const std::string& key, const AssetCacheItem& item) {
+  size_t itemSize = item.data ? item.data->size() : 0;
+  if(itemSize > maxSize)
+    return;
+
+  Shard& shard = GetShard(key);
+
+  shard.mutex.Lock();
+
+  auto it = shard.entries.find(key);
+  if(it != shard.entries.end()) {
+    size -= it->second.item.data ? it->second.item.data->size() : 0;
+    it->second.item = item;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+  }
+  else {
+    shard.lru.push_front(key);
+
+    Entry& entry = shard.entries[key];
+    entry.item = item;
+    entry.lru = shard.lru.begin();
+    count++;
+  }
+
+  size += itemSize;
+
+  // Evict from the shard that grew first, then from the others.
+  while(size > maxSize && EvictOne(shard, key)) {
+  }
+
+  shard.mutex.Unlock();
+
+  for(auto other: shards) {
+    if(size <= maxSize)
+      break;
+
+    if(other == &shard)
+      continue;
+
+    other->mutex.Lock();
+    while(size > maxSize && EvictOne(*other, key)) {
+    }
+    other->mutex.Unlock();
+  }
+}
+
+void AssetCache::Clear() {
+  for(auto shard: shards) {
+    shard->mutex.Lock();
+    for(auto& it: shard->entries) {
+      size -= it.second.item.data ? it.second.item.data->size() : 0;
+    }
+    count -= shard->entries.size();
+    shard->entries.clear();
+    shard->lru.clear();
+    shard->mutex.Unlock();
+  }
+}
+
+json AssetCache::GetStats() const {
+  json stats;
+
+  stats["maxSize"] = maxSize;
+  stats["size"] = (size_t) size;
+  stats["count"] = (size_t) count;
+  stats["hits"] = (size_t) hits;
+  stats["misses"] = (size_t) misses;
+  stats["evictions"] = (size_t) evictions;
+
+  return stats;
+}
+
+AssetCache::Shard& AssetCache::GetShard(const std::string& key) {
+  return *shards[std::hash<std::string>()(key) % shards.size()];
+}
+
+bool AssetCache::EvictOne(Shard& shard, const std::string& keepKey) {
+  if(shard.lru.empty())
+    return false;
+
+  const std::string& key = shard.lru.back();
+  if(key == keepKey)
+    return false;
+
+  auto it = shard.entries.find(key);
+  size -= it->second.item.data ? it->second.item.data->size() : 0;
+  shard.entries.erase(it);
+  shard.lru.pop_back();
+
+  count--;
+  evictions++;
+
+  return true;
+}
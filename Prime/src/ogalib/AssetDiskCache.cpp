@@ -0,0 +1,531 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/ogalib.h>
+#include <ogalib/AssetDiskCache.h>
+#include <algorithm>
+#include <stdio.h>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#ifdef Yield
+#undef Yield
+#endif
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class AssetDiskCacheData {
+public:
+
+  bool enabled;
+  std::string path;
+  uint64_t maxSize;
+  uint64_t size;
+  uint64_t accessCounter;
+  std::unordered_map<std::string, AssetDiskCacheEntry> entries;
+  ThreadMutex* mutex;
+  bool indexDirty;
+  bool indexSaving;
+  size_t storesSinceIndexSave;
+
+  size_t hits;
+  size_t misses;
+  size_t stores;
+  size_t evictions;
+
+public:
+
+  AssetDiskCacheData();
+
+};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+extern ogalib::Data ogalibData;
+static AssetDiskCacheData assetDiskCacheData;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string GetAssetDiskCacheFilePath(const std::string& key);
+static bool ReadAssetDiskCacheFile(const std::string& filePath, std::string& data);
+static bool WriteAssetDiskCacheFile(const std::string& filePath, const void* data, size_t dataSize);
+static void LoadAssetDiskCacheIndex();
+static void ReconcileAssetDiskCacheDirectory();
+static void GetAssetDiskCacheFilenames(std::vector<std::string>& filenames);
+static void SaveAssetDiskCacheIndex();
+static void EvictAssetDiskCache(const std::string& keepKey, std::vector<std::string>& removePaths);
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+AssetDiskCacheEntry::AssetDiskCacheEntry():
+size(0),
+lastAccess(0) {
+
+}
+
+AssetDiskCacheData::AssetDiskCacheData():
+enabled(false),
+maxSize(OGALIB_ASSET_DISK_CACHE_MAX_SIZE),
+size(0),
+accessCounter(0),
+mutex(nullptr),
+indexDirty(false),
+indexSaving(false),
+storesSinceIndexSave(0),
+hits(0),
+misses(0),
+stores(0),
+evictions(0) {
+
+}
+
+void ogalib::InitAssetDiskCache() {
+  auto& data = assetDiskCacheData;
+
+  if(auto it = ogalibData.initParams.find("AssetDiskCache.Path")) {
+    data.path = it.GetString();
+  }
+
+  if(auto it = ogalibData.initParams.find("AssetDiskCache.MaxSize")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      data.maxSize = value.GetUint64();
+    }
+  }
+
+  if(data.path.empty() || data.maxSize == 0)
+    return;
+
+  if(data.path.back() == '/' || data.path.back() == '\\') {
+    data.path.pop_back();
+  }
+
+#if defined(_WIN32) || defined(_WIN64)
+  CreateDirectoryA(data.path.c_str(), NULL);
+#else
+  mkdir(data.path.c_str(), 0755);
+#endif
+
+  data.mutex = new ThreadMutex("ogalib::AssetDiskCache mutex");
+  data.enabled = true;
+
+  LoadAssetDiskCacheIndex();
+  ReconcileAssetDiskCacheDirectory();
+
+  std::vector<std::string> removePaths;
+  EvictAssetDiskCache(std::string(), removePaths);
+  for(const auto& removePath: removePaths) {
+    remove(removePath.c_str());
+  }
+}
+
+void ogalib::ShutdownAssetDiskCache() {
+  auto& data = assetDiskCacheData;
+
+  if(!data.enabled)
+    return;
+
+  // Let a save already in progress finish, then write out whatever it missed.
+  data.mutex->Lock();
+  while(data.indexSaving) {
+    data.mutex->Unlock();
+    Thread::Yield();
+    data.mutex->Lock();
+  }
+  bool indexDirty = data.indexDirty;
+  data.mutex->Unlock();
+
+  if(indexDirty) {
+    SaveAssetDiskCacheIndex();
+  }
+
+  data.entries.clear();
+  data.size = 0;
+  data.enabled = false;
+
+  delete data.mutex;
+  data.mutex = nullptr;
+}
+
+bool ogalib::IsAssetDiskCacheEnabled() {
+  return assetDiskCacheData.enabled;
+}
+
+bool ogalib::ReadAssetDiskCache(const std::string& key, AssetDiskCacheEntry& entry, std::string& fileData) {
+  auto& data = assetDiskCacheData;
+
+  if(!data.enabled)
+    return false;
+
+  data.mutex->Lock();
+  auto it = data.entries.find(key);
+  if(it == data.entries.end()) {
+    data.misses++;
+    data.mutex->Unlock();
+    return false;
+  }
+
+  it->second.lastAccess = ++data.accessCounter;
+  entry = it->second;
+  data.indexDirty = true;
+  data.mutex->Unlock();
+
+  if(ReadAssetDiskCacheFile(GetAssetDiskCacheFilePath(key), fileData) && fileData.size() == entry.size) {
+    data.mutex->Lock();
+    data.hits++;
+    data.mutex->Unlock();
+    return true;
+  }
+
+  // The file is missing or damaged, forget about it.
+  data.mutex->Lock();
+  it = data.entries.find(key);
+  if(it != data.entries.end()) {
+    data.size -= it->second.size;
+    data.entries.erase(it);
+  }
+  data.misses++;
+  data.mutex->Unlock();
+
+  fileData.clear();
+
+  return false;
+}
+
+bool ogalib::WriteAssetDiskCache(const std::string& key, const AssetDiskCacheEntry& entry, const void* fileData, size_t fileDataSize) {
+  auto& data = assetDiskCacheData;
+
+  if(!data.enabled)
+    return false;
+
+  if(fileDataSize > data.maxSize)
+    return false;
+
+  if(!WriteAssetDiskCacheFile(GetAssetDiskCacheFilePath(key), fileData, fileDataSize))
+    return false;
+
+  data.mutex->Lock();
+
+  auto it = data.entries.find(key);
+  if(it != data.entries.end()) {
+    data.size -= it->second.size;
+  }
+
+  auto& useEntry = data.entries[key];
+  useEntry = entry;
+  useEntry.size = fileDataSize;
+  useEntry.lastAccess = ++data.accessCounter;
+  data.size += useEntry.size;
+  data.stores++;
+  data.indexDirty = true;
+
+  std::vector<std::string> removePaths;
+  EvictAssetDiskCache(key, removePaths);
+
+  bool saveIndex = ++data.storesSinceIndexSave >= OGALIB_ASSET_DISK_CACHE_INDEX_SAVE_INTERVAL && !data.indexSaving;
+
+  data.mutex->Unlock();
+
+  for(const auto& removePath: removePaths) {
+    remove(removePath.c_str());
+  }
+
+  if(saveIndex) {
+    SaveAssetDiskCacheIndex();
+  }
+
+  return true;
+}
+
+json ogalib::GetAssetDiskCacheStats() {
+  auto& data = assetDiskCacheData;
+  json stats;
+
+  stats["enabled"] = data.enabled;
+  stats["maxSize"] = (size_t) data.maxSize;
+
+  if(data.enabled) {
+    data.mutex->Lock();
+    stats["size"] = (size_t) data.size;
+    stats["count"] = data.entries.size();
+    stats["hits"] = data.hits;
+    stats["misses"] = data.misses;
+    stats["stores"] = data.stores;
+    stats["evictions"] = data.evictions;
+    data.mutex->Unlock();
+  }
+
+  return stats;
+}
+
+std::string GetAssetDiskCacheFilePath(const std::string& key) {
+  return assetDiskCacheData.path + "/" + key + ".bin";
+}
+
+bool ReadAssetDiskCacheFile(const std::string& filePath, std::string& data) {
+  FILE* file = fopen(filePath.c_str(), "rb");
+  if(!file)
+    return false;
+
+  bool result = false;
+
+  if(fseek(file, 0, SEEK_END) == 0) {
+    long fileSize = ftell(file);
+    if(fileSize >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+      data.resize((size_t) fileSize);
+      result = fileSize == 0 || fread(&data[0], 1, (size_t) fileSize, file) == (size_t) fileSize;
+    }
+  }
+
+  fclose(file);
+
+  return result;
+}
+
+bool WriteAssetDiskCacheFile(const std::string& filePath, const void* data, size_t dataSize) {
+  // Write to a temporary file first so a crash never leaves a partially written entry behind.
+  std::string tempFilePath = string_printf("%s.%lld.tmp", filePath.c_str(), (long long) Thread::GetCurrentThreadId());
+
+  FILE* file = fopen(tempFilePath.c_str(), "wb");
+  if(!file)
+    return false;
+
+  bool result = dataSize == 0 || fwrite(data, 1, dataSize, file) == dataSize;
+  result = fclose(file) == 0 && result;
+
+  if(result) {
+#if defined(_WIN32) || defined(_WIN64)
+    result = MoveFileExA(tempFilePath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    result = rename(tempFilePath.c_str(), filePath.c_str()) == 0;
+#endif
+  }
+
+  if(!result) {
+    remove(tempFilePath.c_str());
+  }
+
+  return result;
+}
+
+void LoadAssetDiskCacheIndex() {
+  auto& data = assetDiskCacheData;
+
+  std::string indexData;
+  if(!ReadAssetDiskCacheFile(data.path + "/index.json", indexData))
+    return;
+
+  json index;
+  if(!index.parse(indexData))
+    return;
+
+  if(auto itEntries = index.find("entries")) {
+    for(auto& it: itEntries) {
+      std::string key = it.key().GetString();
+
+      AssetDiskCacheEntry entry;
+      entry.url = it["url"].GetString();
+      entry.etag = it["etag"].GetString();
+      entry.lastModified = it["lastModified"].GetString();
+      entry.size = it["size"].GetUint64();
+      entry.lastAccess = it["lastAccess"].GetUint64();
+
+      data.entries[key] = entry;
+      data.size += entry.size;
+      data.accessCounter = std::max(data.accessCounter, entry.lastAccess);
+    }
+  }
+}
+
+void ReconcileAssetDiskCacheDirectory() {
+  auto& data = assetDiskCacheData;
+
+  static const std::string binExtension(".bin");
+
+  std::vector<std::string> filenames;
+  GetAssetDiskCacheFilenames(filenames);
+
+  std::unordered_map<std::string, bool> found;
+
+  // Files the index doesn't know about were stored after its last save, or left behind by an interrupted write.
+  for(const auto& filename: filenames) {
+    if(filename == "index.json")
+      continue;
+
+    if(filename.length() > binExtension.length() && filename.compare(filename.length() - binExtension.length(), binExtension.length(), binExtension) == 0) {
+      std::string key = filename.substr(0, filename.length() - binExtension.length());
+      if(data.entries.find(key) != data.entries.end()) {
+        found[key] = true;
+        continue;
+      }
+    }
+
+    remove((data.path + "/" + filename).c_str());
+  }
+
+  for(auto it = data.entries.begin(); it != data.entries.end();) {
+    if(found.find(it->first) == found.end()) {
+      data.size -= it->second.size;
+      it = data.entries.erase(it);
+      data.indexDirty = true;
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void GetAssetDiskCacheFilenames(std::vector<std::string>& filenames) {
+  auto& data = assetDiskCacheData;
+
+#if defined(_WIN32) || defined(_WIN64)
+  WIN32_FIND_DATAA findData;
+  HANDLE find = FindFirstFileA((data.path + "/*").c_str(), &findData);
+  if(find == INVALID_HANDLE_VALUE)
+    return;
+
+  do {
+    if(!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+      filenames.push_back(findData.cFileName);
+    }
+  }
+  while(FindNextFileA(find, &findData));
+
+  FindClose(find);
+#else
+  DIR* dir = opendir(data.path.c_str());
+  if(!dir)
+    return;
+
+  while(struct dirent* entry = readdir(dir)) {
+    std::string filename = entry->d_name;
+    if(filename != "." && filename != "..") {
+      filenames.push_back(filename);
+    }
+  }
+
+  closedir(dir);
+#endif
+}
+
+void SaveAssetDiskCacheIndex() {
+  auto& data = assetDiskCacheData;
+
+  // Only the snapshot is taken under the lock. Serializing and writing happen outside it, one save at a time.
+  data.mutex->Lock();
+  if(data.indexSaving) {
+    data.mutex->Unlock();
+    return;
+  }
+  data.indexSaving = true;
+  data.indexDirty = false;
+  data.storesSinceIndexSave = 0;
+  std::unordered_map<std::string, AssetDiskCacheEntry> snapshot = data.entries;
+  data.mutex->Unlock();
+
+  json entries;
+  for(auto& it: snapshot) {
+    const auto& entry = it.second;
+
+    json js;
+    js["url"] = entry.url;
+    js["etag"] = entry.etag;
+    js["lastModified"] = entry.lastModified;
+    js["size"] = (size_t) entry.size;
+    js["lastAccess"] = (size_t) entry.lastAccess;
+
+    entries[it.first] = js;
+  }
+
+  json index;
+  index["entries"] = entries;
+
+  std::string indexData = index.tostring();
+  bool saved = WriteAssetDiskCacheFile(data.path + "/index.json", indexData.data(), indexData.size());
+
+  data.mutex->Lock();
+  if(!saved) {
+    data.indexDirty = true;
+  }
+  data.indexSaving = false;
+  data.mutex->Unlock();
+}
+
+void EvictAssetDiskCache(const std::string& keepKey, std::vector<std::string>& removePaths) {
+  auto& data = assetDiskCacheData;
+
+  if(data.size <= data.maxSize)
+    return;
+
+  std::vector<std::pair<uint64_t, std::string>> order;
+  order.reserve(data.entries.size());
+  for(auto& it: data.entries) {
+    if(it.first != keepKey) {
+      order.push_back({it.second.lastAccess, it.first});
+    }
+  }
+
+  std::sort(order.begin(), order.end());
+
+  for(auto& it: order) {
+    if(data.size <= data.maxSize)
+      break;
+
+    auto itEntry = data.entries.find(it.second);
+    data.size -= itEntry->second.size;
+    data.entries.erase(itEntry);
+    data.evictions++;
+    data.indexDirty = true;
+
+    removePaths.push_back(GetAssetDiskCacheFilePath(it.second));
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/Event.h>
+#include <chrono>
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+Event::Event(const char* name, bool signaled):
+condition(name),
+signaled(signaled) {
+
+}
+
+Event::~Event() {
+
+}
+
+void Event::Set() {
+  std::vector<std::function<void()>> setCallbacks;
+
+  {
+    ThreadConditionLock lock(condition);
+    if(signaled)
+      return;
+
+    signaled = true;
+    setCallbacks.swap(callbacks);
+    condition.SignalAll();
+  }
+
+  for(auto& callback: setCallbacks) {
+    callback();
+  }
+}
+
+void Event::Reset() {
+  ThreadConditionLock lock(condition);
+  signaled = false;
+}
+
+bool Event::IsSet() {
+  ThreadConditionLock lock(condition);
+  return signaled;
+}
+
+void Event::Wait() {
+  ThreadConditionLock lock(condition);
+  while(!signaled) {
+    condition.Wait();
+  }
+}
+
+bool Event::Wait(double timeout) {
+  auto endTime = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+
+  ThreadConditionLock lock(condition);
+  while(!signaled) {
+    double remaining = std::chrono::duration<double>(endTime - std::chrono::steady_clock::now()).count();
+    if(remaining <= 0.0)
+      break;
+
+    condition.Wait(remaining);
+  }
+
+  return signaled;
+}
+
+void Event::Then(std::function<void()> callback) {
+  if(!callback)
+    return;
+
+  {
+    ThreadConditionLock lock(condition);
+    if(!signaled) {
+      callbacks.push_back(callback);
+      return;
+    }
+  }
+
+  callback();
+}
@@ -33,101 +33,580 @@ using namespace ogalib;
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <ogalib/ogalib.h>
-#include <set>
-#include <list>
+#include <deque>
+#include <atomic>
+#include <chrono>
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+// Lock-free intrusive stack. Consumers always take the whole stack at once, so
+// there is no ABA problem.
+class JobStack {
+private:
+
+  std::atomic<Job*> head;
+
+public:
+
+  JobStack(): head(nullptr) {}
+
+public:
+
+  void Push(Job* job) {
+    Job* top = head.load(std::memory_order_relaxed);
+    do {
+      job->next = top;
+    } while(!head.compare_exchange_weak(top, job, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // Returns the jobs in the order they were pushed.
+  Job* PopAll() {
+    Job* job = head.exchange(nullptr, std::memory_order_acquire);
+    Job* list = nullptr;
+    while(job) {
+      Job* next = job->next;
+      job->next = list;
+      list = job;
+      job = next;
+    }
+
+    return list;
+  }
+
+  bool IsEmpty() const {
+    return head.load(std::memory_order_acquire) == nullptr;
+  }
+
+  static Job* Next(Job* job) {
+    return job->next;
+  }
+
+};
+
+// Per worker deque. The owner takes from the front and thieves take from the back.
+class JobQueue {
+private:
+
+  ThreadMutex mutex;
+  std::deque<Job*> jobs;
+  std::atomic<size_t> size;
+
+public:
+
+  JobQueue(): mutex("ogalib::Job queue mutex"), size(0) {}
+
+public:
+
+  void Push(Job* job) {
+    mutex.Lock();
+    jobs.push_back(job);
+    size.store(jobs.size(), std::memory_order_relaxed);
+    mutex.Unlock();
+  }
+
+  void PushList(Job* list) {
+    mutex.Lock();
+    for(Job* job = list; job; job = JobStack::Next(job)) {
+      jobs.push_back(job);
+    }
+    size.store(jobs.size(), std::memory_order_relaxed);
+    mutex.Unlock();
+  }
+
+  Job* Pop() {
+    if(size.load(std::memory_order_relaxed) == 0)
+      return nullptr;
+
+    Job* job = nullptr;
+    mutex.Lock();
+    if(!jobs.empty()) {
+      job = jobs.front();
+      jobs.pop_front();
+      size.store(jobs.size(), std::memory_order_relaxed);
+    }
+    mutex.Unlock();
+
+    return job;
+  }
+
+  // Takes half of this queue, returning one job and moving the rest to thief.
+  Job* Steal(JobQueue& thief, size_t& count) {
+    count = 0;
+    if(size.load(std::memory_order_relaxed) == 0)
+      return nullptr;
+
+    std::vector<Job*> stolen;
+    mutex.Lock();
+    size_t stealCount = (jobs.size() + 1) / 2;
+    while(stealCount-- > 0) {
+      stolen.push_back(jobs.back());
+      jobs.pop_back();
+    }
+    size.store(jobs.size(), std::memory_order_relaxed);
+    mutex.Unlock();
+
+    if(stolen.empty())
+      return nullptr;
+
+    count = stolen.size();
+    Job* job = stolen.back();
+    stolen.pop_back();
+
+    if(!stolen.empty()) {
+      thief.mutex.Lock();
+      for(auto it = stolen.rbegin(); it != stolen.rend(); ++it) {
+        thief.jobs.push_back(*it);
+      }
+      thief.size.store(thief.jobs.size(), std::memory_order_relaxed);
+      thief.mutex.Unlock();
+    }
+
+    return job;
+  }
+
+};
+
+// Event count used to park idle workers. Notify is a couple of atomic loads when
+// no worker is sleeping. A waiter calls PrepareWait, checks for work again and
+// then either CancelWait or Wait, so a notify in between is never lost.
+class JobEventCount {
+private:
+
+  std::atomic<uint32_t> epoch;
+  std::atomic<uint32_t> waiters;
+  ThreadCondition condition;
+
+public:
+
+  JobEventCount(const char* name): epoch(0), waiters(0), condition(name) {}
+
+public:
+
+  uint32_t PrepareWait() {
+    waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch.load(std::memory_order_acquire);
+  }
+
+  void CancelWait() {
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void Wait(uint32_t key, const std::atomic<bool>& active) {
+    {
+      ThreadConditionLock lock(condition);
+      while(epoch.load(std::memory_order_acquire) == key && active.load(std::memory_order_acquire)) {
+        condition.Wait();
+      }
+    }
+
+    waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool Notify(bool all = false) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(waiters.load(std::memory_order_seq_cst) == 0)
+      return false;
+
+    ThreadConditionLock lock(condition);
+    epoch.fetch_add(1, std::memory_order_release);
+    if(all)
+      condition.SignalAll();
+    else
+      condition.Signal();
+
+    return true;
+  }
+
+  void ShutdownThread(Thread*& thread) {
+    {
+      ThreadConditionLock lock(condition);
+      epoch.fetch_add(1, std::memory_order_release);
+      condition.SignalAll();
+    }
+
+    condition.ShutdownThread(thread);
+  }
+
+};
+
+class JobState {
+private:
+
+  ThreadMutex mutex;
+  std::atomic<bool> completed;
+  std::vector<std::function<void()>> continuations;
+
+public:
+
+  JobState(): mutex("ogalib::JobState mutex"), completed(false) {}
+
+public:
+
+  bool IsCompleted() const {
+    return completed.load(std::memory_order_acquire);
+  }
+
+  // Calls the continuation right away when the job has already completed.
+  void AddContinuation(const std::function<void()>& continuation) {
+    mutex.Lock();
+    if(!completed) {
+      continuations.push_back(continuation);
+      mutex.Unlock();
+      return;
+    }
+    mutex.Unlock();
+
+    continuation();
+  }
+
+  void Complete();
+
+};
+
+// Free list of Job sized blocks. Blocks freed on any thread go onto a shared
+// lock-free stack, and each thread refills its own cache by taking the whole
+// stack at once, so there is no ABA problem.
+class JobPool {
+private:
+
+  struct Block {
+    Block* next;
+  };
+
+  struct Cache {
+    Block* head = nullptr;
+    JobPool* pool = nullptr;
+
+    ~Cache() {
+      if(pool)
+        pool->Return(head);
+    }
+  };
+
+  std::atomic<Block*> freeBlocks;
+  std::atomic<size_t> allocatedCount;
+  std::atomic<size_t> reusedCount;
+
+  static thread_local Cache cache;
+
+public:
+
+  JobPool(): freeBlocks(nullptr), allocatedCount(0), reusedCount(0) {}
+
+public:
+
+  void* Allocate() {
+    if(!cache.head) {
+      cache.head = freeBlocks.exchange(nullptr, std::memory_order_acquire);
+      cache.pool = this;
+    }
+
+    if(Block* block = cache.head) {
+      cache.head = block->next;
+      reusedCount++;
+      return block;
+    }
+
+    allocatedCount++;
+    return ::operator new(std::max(sizeof(Job), sizeof(Block)));
+  }
+
+  void Free(void* p) {
+    if(!p)
+      return;
+
+    Block* block = static_cast<Block*>(p);
+    block->next = nullptr;
+    Return(block);
+  }
+
+  // Frees every block not held by another thread's cache.
+  void Release() {
+    Return(cache.head);
+    cache.head = nullptr;
+
+    Block* block = freeBlocks.exchange(nullptr, std::memory_order_acquire);
+    while(block) {
+      Block* next = block->next;
+      ::operator delete(block);
+      allocatedCount--;
+      block = next;
+    }
+  }
+
+  size_t GetAllocatedCount() const {return allocatedCount;}
+  size_t GetReusedCount() const {return reusedCount;}
+
+private:
+
+  void Return(Block* list) {
+    if(!list)
+      return;
+
+    Block* last = list;
+    while(last->next) {
+      last = last->next;
+    }
+
+    Block* top = freeBlocks.load(std::memory_order_relaxed);
+    do {
+      last->next = top;
+    } while(!freeBlocks.compare_exchange_weak(top, list, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+};
+
+thread_local JobPool::Cache JobPool::cache;
+
+};
 
 ////////////////////////////////////////////////////////////////////////////////
 // Variables
 ////////////////////////////////////////////////////////////////////////////////
 
-static ThreadMutex* jobMutex = nullptr;
-static std::set<Job*> jobs;
-static std::list<Job*> jobQueue;
-static std::vector<Job*> jobCompletedStack;
-static size_t jobsInProgress = 0;
+static std::atomic<size_t> jobsPending(0);
+static JobPool jobPool;
 
-static bool* workerThreadActive = nullptr;
-static bool* workerThreadWait = nullptr;
-static ThreadMutex* workerThreadMutex = nullptr;
-static ThreadCondition** workerThreadCondition = nullptr;
+static JobStack jobInjectionStack;
+static JobStack jobCompletedStack;
+static JobQueue* expressJobQueue = nullptr;
+static JobQueue* workerJobQueues = nullptr;
+static JobEventCount* workerEvent = nullptr;
+static JobEventCount* expressWorkerEvent = nullptr;
+static JobEventCount* completionEvent = nullptr;
+static JobEventCount* responseEvent = nullptr;
+
+static std::atomic<bool> workerThreadActive(false);
 static Thread** workerThread = nullptr;
 static uint32_t* workerThreadNumbers = nullptr;
 static uint32_t workerThreadCount = 0;
-static uint32_t workerThreadIndex = 0;
+static thread_local int32_t currentWorkerThreadNumber = -1;
+
+static JobQueue* ioJobQueue = nullptr;
+static JobEventCount* ioWorkerEvent = nullptr;
+static Thread** ioWorkerThread = nullptr;
+static uint32_t ioWorkerThreadCount = 0;
+
+static std::atomic<size_t> jobsSubmitted(0);
+static std::atomic<size_t> jobsCancelled(0);
+static std::atomic<size_t> jobsExecuted(0);
+static std::atomic<size_t> jobsStolen(0);
+static std::atomic<size_t> workerWakeups(0);
+static std::atomic<size_t> ioJobsSubmitted(0);
+static std::atomic<size_t> ioJobsExecuted(0);
+
+// Completed jobs waiting for their response, one FIFO per JobPriority. Main thread only.
+static std::deque<Job*> jobResponseQueues[3];
+static size_t jobResponsesCalled = 0;
+static size_t jobResponsesDeferred = 0;
+static double jobResponseTime = 0.0;
+static double jobResponseLastTime = 0.0;
+static double jobResponseMaxTime = 0.0;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Functions
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace ogalib {
-void* JobThread(void* param);
 void* JobWorkerThread(void* param);
+void* JobIOWorkerThread(void* param);
 };
 
+static Job* FindWorkerJob(uint32_t workerThreadNumber);
+
 ////////////////////////////////////////////////////////////////////////////////
 // Classes
 ////////////////////////////////////////////////////////////////////////////////
 
-Job::Job(std::function<void(Job&)> callback, std::function<void(Job&)> response, JobType type):
-callback(callback),
-response(response),
-thread(nullptr),
+void JobState::Complete() {
+  std::vector<std::function<void()>> callbacks;
+
+  mutex.Lock();
+  completed = true;
+  callbacks.swap(continuations);
+  mutex.Unlock();
+
+  for(auto& callback: callbacks) {
+    callback();
+  }
+
+  completionEvent->Notify(true);
+}
+
+bool JobHandle::IsCompleted() const {
+  return !state || state->IsCompleted();
+}
+
+void JobHandle::Wait() const {
+  if(!state)
+    return;
+
+  std::shared_ptr<JobState> waitState = state;
+  Job::WaitUntil([waitState]() {
+    return waitState->IsCompleted();
+  });
+}
+
+JobHandle JobHandle::Then(JobFunction callback, JobType type) const {
+  return Job::Start(std::move(callback), nullptr, {*this}, type);
+}
+
+JobHandle JobHandle::Then(JobFunction callback, JobFunction response, JobType type) const {
+  return Job::Start(std::move(callback), std::move(response), {*this}, type);
+}
+
+Job::Job(JobFunction callback, JobFunction response, JobType type):
+callback(std::move(callback)),
+response(std::move(response)),
 completed(false),
-type(type) {
+type(type),
+priority(JobPriority::Normal),
+next(nullptr) {
   InitCommon();
 }
 
-Job::Job(std::function<void(Job&)> callback, std::function<void(Job&)> response, const json& data, JobType type):
-callback(callback),
-response(response),
-thread(nullptr),
+Job::Job(JobFunction callback, JobFunction response, const json& data, JobType type):
+callback(std::move(callback)),
+response(std::move(response)),
 completed(false),
 type(type),
+priority(JobPriority::Normal),
+next(nullptr),
 data(data) {
   InitCommon();
 }
 
+Job::Job(JobFunction callback, JobFunction response, const CancelToken& cancel, JobType type):
+callback(std::move(callback)),
+response(std::move(response)),
+completed(false),
+type(type),
+priority(JobPriority::Normal),
+next(nullptr),
+cancel(cancel) {
+  InitCommon();
+}
+
+Job::Job(JobFunction callback, JobFunction response, JobPriority priority, JobType type):
+callback(std::move(callback)),
+response(std::move(response)),
+completed(false),
+type(type),
+priority(priority),
+next(nullptr) {
+  InitCommon();
+}
+
+Job::Job(JobFunction callback, JobFunction response, const json* data, JobType type, const std::vector<JobHandle>& dependencies):
+callback(std::move(callback)),
+response(std::move(response)),
+completed(false),
+type(type),
+priority(JobPriority::Normal),
+next(nullptr),
+state(std::make_shared<JobState>()) {
+  if(data)
+    this->data.get() = *data;
+
+  InitCommon(dependencies);
+}
+
 Job::~Job() {
-  if(thread)
-    delete thread;
+
+}
+
+void* Job::operator new(size_t size) {
+  ogalibAssert(size == sizeof(Job), "Unexpected job allocation size.");
+  return jobPool.Allocate();
+}
+
+void Job::operator delete(void* p) {
+  jobPool.Free(p);
 }
 
-void Job::InitCommon() {
-  if(type == JobType::Independent) {
-    jobMutex->Lock();
-    jobs.insert(this);
-    jobMutex->Unlock();
+void Job::InitCommon(const std::vector<JobHandle>& dependencies) {
+  jobsPending++;
 
-    if(callback) {
-      thread = new Thread(JobThread, this);
-      thread->Start();
+  if(dependencies.empty()) {
+    Submit();
+    return;
+  }
+
+  // The extra count keeps the job from starting before every dependency is registered.
+  pendingDependencies = dependencies.size() + 1;
+  for(auto& dependency: dependencies) {
+    if(dependency.state) {
+      dependency.state->AddContinuation([this]() {
+        DependencyCompleted();
+      });
     }
     else {
-      completed = true;
+      DependencyCompleted();
     }
   }
+
+  DependencyCompleted();
+}
+
+void Job::DependencyCompleted() {
+  if(--pendingDependencies == 0) {
+    Submit();
+  }
+}
+
+void Job::Submit() {
+  if(!callback) {
+    completed = true;
+    if(state)
+      state->Complete();
+    jobCompletedStack.Push(this);
+    responseEvent->Notify();
+  }
+  else if(type == JobType::IO || type == JobType::Independent) {
+    ioJobsSubmitted++;
+    ioJobQueue->Push(this);
+    ioWorkerEvent->Notify();
+  }
   else {
-    if(callback) {
-      workerThreadMutex->Lock();
-      jobQueue.push_back(this);
-      workerThreadMutex->Unlock();
-
-      workerThreadMutex->Lock();
-      workerThreadCondition[workerThreadIndex]->Signal(workerThreadWait[workerThreadIndex]);
-      if(++workerThreadIndex >= workerThreadCount)
-        workerThreadIndex = 0;
-      workerThreadMutex->Unlock();
+    jobsSubmitted++;
+
+    if(type == JobType::Express) {
+      expressJobQueue->Push(this);
+      if(!expressWorkerEvent->Notify())
+        workerEvent->Notify();
+    }
+    else if(currentWorkerThreadNumber >= 0) {
+      workerJobQueues[currentWorkerThreadNumber].Push(this);
+      workerEvent->Notify();
     }
     else {
-      completed = true;
-
-      workerThreadMutex->Lock();
-      jobCompletedStack.push_back(this);
-      workerThreadMutex->Unlock();
+      jobInjectionStack.Push(this);
+      workerEvent->Notify();
     }
   }
 }
 
+void Job::Execute() {
+  if(cancel.IsCancelled()) {
+    jobsCancelled++;
+  }
+  else if(callback) {
+    callback(*this);
+  }
+  completed = true;
+
+  if(state)
+    state->Complete();
+
+  jobCompletedStack.Push(this);
+  responseEvent->Notify();
+}
+
 void Job::Call(void* param, const std::string& error) {
   this->param = param;
   this->error = error;
@@ -136,168 +615,344 @@ void Job::Call(void* param, const std::string& error) {
   }
 }
 
-void* ogalib::JobThread(void* param) {
-  Job* job = static_cast<Job*>(param);
-  if(job->callback) {
-    job->callback(*job);
-  }
-  job->completed = true;
-  return nullptr;
-}
-
 void Job::InitGlobal() {
-  jobMutex = new ThreadMutex("Job Callback Mutex");
-
   InitWorkerThread();
 }
 
 void Job::ShutdownGlobal() {
   ShutdownWorkerThread();
 
-  std::vector<Job*> removeCallbacks;
-  for(auto jc: jobs) {
-    removeCallbacks.push_back(jc);
-  }
+  jobPool.Release();
+}
 
-  for(auto jc: removeCallbacks) {
-    delete jc;
+void Job::ProcessGlobal(double timeBudget) {
+  Job* jc = jobCompletedStack.PopAll();
+  while(jc) {
+    Job* next = jc->next;
+    jobResponseQueues[(int) jc->GetPriority()].push_back(jc);
+    jc = next;
   }
 
-  jobs.clear();
+  auto startTime = std::chrono::steady_clock::now();
+  double elapsed = 0.0;
+  size_t called = 0;
+
+  for(int i = 2; i >= 0; i--) {
+    std::deque<Job*>& queue = jobResponseQueues[i];
+    while(!queue.empty()) {
+      // Always make some progress, then leave the rest for later frames once the budget is spent.
+      if(timeBudget > 0.0 && called > 0 && elapsed >= timeBudget)
+        break;
+
+      jc = queue.front();
+      queue.pop_front();
 
-  if(jobMutex) {
-    delete jobMutex;
-    jobMutex = nullptr;
+      jc->Call(jc->data.IsAllocated() ? &jc->data.get() : nullptr);
+      delete jc;
+      jobsPending--;
+      called++;
+
+      elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
   }
+
+  size_t deferred = jobResponseQueues[0].size() + jobResponseQueues[1].size() + jobResponseQueues[2].size();
+  if(deferred > 0)
+    jobResponsesDeferred++;
+
+  jobResponsesCalled += called;
+  jobResponseTime += elapsed;
+  jobResponseLastTime = elapsed;
+  jobResponseMaxTime = std::max(jobResponseMaxTime, elapsed);
+}
+
+bool Job::HasJobs() {
+  return jobsPending > 0;
 }
 
-void Job::ProcessGlobal() {
-  if(jobQueue.size() > 0) {
-    workerThreadMutex->Lock();
-    workerThreadCondition[workerThreadIndex]->Signal(workerThreadWait[workerThreadIndex]);
-    if(++workerThreadIndex >= workerThreadCount)
-      workerThreadIndex = 0;
-    workerThreadMutex->Unlock();
+void Job::WaitForResponses() {
+  auto ready = []() {
+    return jobsPending == 0 || !jobCompletedStack.IsEmpty() || !jobResponseQueues[0].empty() || !jobResponseQueues[1].empty() || !jobResponseQueues[2].empty();
+  };
+
+  while(!ready() && workerThreadActive) {
+    uint32_t key = responseEvent->PrepareWait();
+    if(ready()) {
+      responseEvent->CancelWait();
+      break;
+    }
+
+    responseEvent->Wait(key, workerThreadActive);
   }
+}
 
-  if(jobs.size() == 0 && jobCompletedStack.size() == 0)
-    return;
+json Job::GetStats() {
+  json stats;
+
+  stats["workerThreadCount"] = (size_t) workerThreadCount;
+  stats["pending"] = (size_t) jobsPending;
+  stats["submitted"] = (size_t) jobsSubmitted;
+  stats["cancelled"] = (size_t) jobsCancelled;
+  stats["executed"] = (size_t) jobsExecuted;
+  stats["stolen"] = (size_t) jobsStolen;
+  stats["wakeups"] = (size_t) workerWakeups;
+  stats["ioWorkerThreadCount"] = (size_t) ioWorkerThreadCount;
+  stats["ioSubmitted"] = (size_t) ioJobsSubmitted;
+  stats["ioExecuted"] = (size_t) ioJobsExecuted;
+  stats["responsesPending"] = jobResponseQueues[0].size() + jobResponseQueues[1].size() + jobResponseQueues[2].size();
+  stats["responsesCalled"] = jobResponsesCalled;
+  stats["responsesDeferred"] = jobResponsesDeferred;
+  stats["responseTime"] = jobResponseTime;
+  stats["responseLastTime"] = jobResponseLastTime;
+  stats["responseMaxTime"] = jobResponseMaxTime;
+  stats["poolAllocated"] = jobPool.GetAllocatedCount();
+  stats["poolReused"] = jobPool.GetReusedCount();
+
+  return stats;
+}
 
-  std::vector<Job*> processJobs;
-  std::vector<Job*> removeJobs;
+JobHandle Job::Start(JobFunction callback, JobType type) {
+  return Start(std::move(callback), nullptr, std::vector<JobHandle>(), type);
+}
 
-  workerThreadMutex->Lock();
-  for(auto jc: jobCompletedStack) {
-    processJobs.push_back(jc);
-  }  
-  jobCompletedStack.clear();
-  workerThreadMutex->Unlock();
+JobHandle Job::Start(JobFunction callback, JobFunction response, const std::vector<JobHandle>& dependencies, JobType type) {
+  Job* job = new Job(std::move(callback), std::move(response), nullptr, type, dependencies);
 
-  for(auto jc: processJobs) {
-    if(jc->completed) {
-      jc->Call(&jc->data);
-      removeJobs.push_back(jc);
-    }
+  JobHandle handle;
+  handle.state = job->state;
+  return handle;
+}
+
+JobHandle Job::Start(JobFunction callback, JobFunction response, const std::vector<JobHandle>& dependencies, const json& data, JobType type) {
+  Job* job = new Job(std::move(callback), std::move(response), &data, type, dependencies);
+
+  JobHandle handle;
+  handle.state = job->state;
+  return handle;
+}
+
+JobHandle Job::WhenAll(const std::vector<JobHandle>& handles) {
+  return Start(nullptr, nullptr, handles, JobType::Default);
+}
+
+void Job::ParallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& callback, size_t grainSize) {
+  if(end <= begin)
+    return;
+
+  size_t count = end - begin;
+  if(grainSize == 0) {
+    grainSize = std::max(count / (std::max(workerThreadCount, (uint32_t) 1) * 4), (size_t) 1);
   }
 
-  for(auto jc: removeJobs) {
-    delete jc;
+  size_t chunkCount = (count + grainSize - 1) / grainSize;
+  if(chunkCount == 1 || workerThreadCount < 2) {
+    callback(begin, end);
+    return;
   }
 
-  processJobs.clear();
-  removeJobs.clear();
+  struct ParallelForState {
+    std::atomic<size_t> nextChunk;
+    std::atomic<size_t> remainingChunks;
+  };
 
-  jobMutex->Lock();
-  for(auto jc: jobs) {
-    processJobs.push_back(jc);
-  }
-  jobMutex->Unlock();
+  auto forState = std::make_shared<ParallelForState>();
+  forState->nextChunk = 0;
+  forState->remainingChunks = chunkCount;
+
+  // Helpers that start after every chunk is claimed return without touching callback.
+  const std::function<void(size_t, size_t)>* useCallback = &callback;
+  auto runChunks = [forState, useCallback, begin, end, grainSize, chunkCount]() {
+    for(;;) {
+      size_t chunk = forState->nextChunk++;
+      if(chunk >= chunkCount)
+        break;
+
+      size_t chunkBegin = begin + chunk * grainSize;
+      (*useCallback)(chunkBegin, std::min(chunkBegin + grainSize, end));
 
-  for(auto jc: processJobs) {
-    if(jc->completed) {
-      jc->Call(&jc->data);
-      removeJobs.push_back(jc);
+      if(--forState->remainingChunks == 0) {
+        completionEvent->Notify(true);
+      }
     }
-  }
+  };
 
-  jobMutex->Lock();
-  for(auto jc: removeJobs) {
-    jobs.erase(jc);
+  size_t helperCount = std::min(chunkCount, (size_t) workerThreadCount) - 1;
+  for(size_t i = 0; i < helperCount; i++) {
+    new Job([runChunks](Job&) {
+      runChunks();
+    }, nullptr);
   }
-  jobMutex->Unlock();
 
-  for(auto jc: removeJobs) {
-    delete jc;
-  }
-}
+  runChunks();
 
-bool Job::HasJobs() {
-  size_t count;
+  WaitUntil([forState]() {
+    return forState->remainingChunks == 0;
+  });
+}
 
-  jobMutex->Lock();
-  count = jobsInProgress + jobs.size() + jobQueue.size() + jobCompletedStack.size();
-  jobMutex->Unlock();
+void Job::WaitUntil(const std::function<bool()>& done) {
+  // Workers keep running other jobs while they wait, so nested waits cannot starve the pool.
+  if(currentWorkerThreadNumber >= 0) {
+    while(!done()) {
+      Job* job = FindWorkerJob((uint32_t) currentWorkerThreadNumber);
+      if(job) {
+        job->Execute();
+        jobsExecuted++;
+      }
+      else {
+        Thread::Yield();
+      }
+    }
+  }
+  else {
+    while(!done() && workerThreadActive) {
+      uint32_t key = completionEvent->PrepareWait();
+      if(done()) {
+        completionEvent->CancelWait();
+        break;
+      }
 
-  return count > 0;
+      completionEvent->Wait(key, workerThreadActive);
+    }
+  }
 }
 
 void Job::InitWorkerThread() {
-  workerThreadMutex = new ThreadMutex("ogalib::Job worker thread mutex", true);
+  uint32_t deviceThreadCount = (uint32_t) Thread::GetDeviceThreadCount();
 
-  uint32_t maxWorkerThreadCount = (uint32_t) Thread::GetDeviceThreadCount();
+  // A configured count is used as is, even past the device thread count.
+  if(OGALIB_JOB_CALLBACK_WORKER_COUNT > 0) {
+    workerThreadCount = (uint32_t) OGALIB_JOB_CALLBACK_WORKER_COUNT;
+  }
+  else {
+    // Leave a thread for the main loop, but always keep the express lane plus one general worker.
+    workerThreadCount = deviceThreadCount > 1 ? std::max(deviceThreadCount - 1, (uint32_t) 2) : 1;
+  }
 
-  workerThreadCount = std::min(maxWorkerThreadCount, (uint32_t) OGALIB_JOB_CALLBACK_WORKER_COUNT);
   if(workerThreadCount < 1)
     workerThreadCount = 1;
-  workerThreadCondition = new ThreadCondition*[workerThreadCount];
+
+  expressJobQueue = new JobQueue();
+  workerJobQueues = new JobQueue[workerThreadCount];
+  workerEvent = new JobEventCount("ogalib::Job worker thread condition");
+  expressWorkerEvent = new JobEventCount("ogalib::Job express worker thread condition");
+  completionEvent = new JobEventCount("ogalib::Job completion condition");
+  responseEvent = new JobEventCount("ogalib::Job response condition");
   workerThread = new Thread*[workerThreadCount];
   workerThreadNumbers = new uint32_t[workerThreadCount];
-  workerThreadActive = new bool[workerThreadCount];
-  workerThreadWait = new bool[workerThreadCount];
+  workerThreadActive = true;
+
+  jobsSubmitted = 0;
+  jobsCancelled = 0;
+  jobsExecuted = 0;
+  jobsStolen = 0;
+  workerWakeups = 0;
+  ioJobsSubmitted = 0;
+  ioJobsExecuted = 0;
+  jobResponsesCalled = 0;
+  jobResponsesDeferred = 0;
+  jobResponseTime = 0.0;
+  jobResponseLastTime = 0.0;
+  jobResponseMaxTime = 0.0;
 
   for(uint32_t i = 0; i < workerThreadCount; i++) {
-    workerThreadActive[i] = true;
-    workerThreadWait[i] = true;
     workerThreadNumbers[i] = i;
-    workerThreadCondition[i] = new ThreadCondition(string_printf("ogalib::Job worker thread condition (%d)", i).c_str());
     workerThread[i] = new Thread(JobWorkerThread, &workerThreadNumbers[i], string_printf("ogalib::Job worker thread (%d)", i).c_str());
     workerThread[i]->SetPriority(OGALIB_JOB_CALLBACK_WORKER_THREAD_PRIORITY);
     if(!workerThread[i]->Start()) {
       ogalibAssert(false, "Could not start ogalib::Job worker thread.");
     }
   }
+
+  // Blocking I/O gets its own threads so slow requests never hold up CPU work.
+  ioWorkerThreadCount = std::max((uint32_t) OGALIB_JOB_IO_WORKER_COUNT, (uint32_t) 1);
+  ioJobQueue = new JobQueue();
+  ioWorkerEvent = new JobEventCount("ogalib::Job I/O worker thread condition");
+  ioWorkerThread = new Thread*[ioWorkerThreadCount];
+
+  for(uint32_t i = 0; i < ioWorkerThreadCount; i++) {
+    ioWorkerThread[i] = new Thread(JobIOWorkerThread, nullptr, string_printf("ogalib::Job I/O worker thread (%d)", i).c_str());
+    if(!ioWorkerThread[i]->Start()) {
+      ogalibAssert(false, "Could not start ogalib::Job I/O worker thread.");
+    }
+  }
 }
 
 void Job::ShutdownWorkerThread() {
+  workerThreadActive = false;
+
   for(uint32_t i = 0; i < workerThreadCount; i++) {
-    workerThreadActive[i] = false;
+    if(i == 0 && workerThreadCount > 1)
+      expressWorkerEvent->ShutdownThread(workerThread[i]);
+    else
+      workerEvent->ShutdownThread(workerThread[i]);
   }
 
-  for(uint32_t i = 0; i < workerThreadCount; i++) {
-    if(workerThreadCondition[i]) {
-      workerThreadCondition[i]->ShutdownThread(workerThread[i], workerThreadWait[i]);
-      delete workerThreadCondition[i];
-      workerThreadCondition[i] = nullptr;
-    }
+  for(uint32_t i = 0; i < ioWorkerThreadCount; i++) {
+    ioWorkerEvent->ShutdownThread(ioWorkerThread[i]);
   }
 
-  workerThreadMutex->Lock();
-  for(auto jc: jobCompletedStack) {
+  Job* jc = jobCompletedStack.PopAll();
+  while(jc) {
+    Job* next = jc->next;
     delete jc;
+    jobsPending--;
+    jc = next;
+  }
+
+  for(auto& queue: jobResponseQueues) {
+    for(auto jc: queue) {
+      delete jc;
+      jobsPending--;
+    }
+    queue.clear();
   }
-  jobCompletedStack.clear();
-  workerThreadMutex->Unlock();
 
   ogalibAssert(!HasJobs(), "Expected to find no more jobs.");
 
-  if(workerThreadMutex) {
-    delete workerThreadMutex;
-    workerThreadMutex = nullptr;
+  if(workerEvent) {
+    delete workerEvent;
+    workerEvent = nullptr;
   }
 
-  if(workerThreadCondition) {
-    delete[] workerThreadCondition;
-    workerThreadCondition = nullptr;
+  if(expressWorkerEvent) {
+    delete expressWorkerEvent;
+    expressWorkerEvent = nullptr;
+  }
+
+  if(completionEvent) {
+    delete completionEvent;
+    completionEvent = nullptr;
+  }
+
+  if(responseEvent) {
+    delete responseEvent;
+    responseEvent = nullptr;
+  }
+
+  if(ioWorkerEvent) {
+    delete ioWorkerEvent;
+    ioWorkerEvent = nullptr;
+  }
+
+  if(ioJobQueue) {
+    delete ioJobQueue;
+    ioJobQueue = nullptr;
+  }
+
+  if(ioWorkerThread) {
+    delete[] ioWorkerThread;
+    ioWorkerThread = nullptr;
+  }
+
+  if(workerJobQueues) {
+    delete[] workerJobQueues;
+    workerJobQueues = nullptr;
+  }
+
+  if(expressJobQueue) {
+    delete expressJobQueue;
+    expressJobQueue = nullptr;
   }
 
   if(workerThread) {
@@ -309,68 +964,93 @@ void Job::ShutdownWorkerThread() {
     delete[] workerThreadNumbers;
     workerThreadNumbers = nullptr;
   }
+}
+
+static Job* FindWorkerJob(uint32_t workerThreadNumber) {
+  // Worker 0 is designated as an "express lane" for jobs that perform quickly.
+  if(workerThreadNumber == 0 && workerThreadCount > 1)
+    return expressJobQueue->Pop();
+
+  JobQueue& queue = workerJobQueues[workerThreadNumber];
+
+  Job* job = queue.Pop();
+  if(job)
+    return job;
+
+  job = expressJobQueue->Pop();
+  if(job)
+    return job;
 
-  if(workerThreadActive) {
-    delete[] workerThreadActive;
-    workerThreadActive = nullptr;
+  job = jobInjectionStack.PopAll();
+  if(job) {
+    Job* rest = JobStack::Next(job);
+    if(rest) {
+      queue.PushList(rest);
+      workerEvent->Notify(true);
+    }
+    return job;
   }
 
-  if(workerThreadWait) {
-    delete[] workerThreadWait;
-    workerThreadWait = nullptr;
+  for(uint32_t i = 1; i < workerThreadCount; i++) {
+    size_t count;
+    job = workerJobQueues[(workerThreadNumber + i) % workerThreadCount].Steal(queue, count);
+    if(job) {
+      jobsStolen += count;
+      return job;
+    }
   }
+
+  return nullptr;
 }
 
 void* ogalib::JobWorkerThread(void* param) {
   uint32_t* workerThreadNumbers = (uint32_t*) param;
   uint32_t workerThreadNumber = *workerThreadNumbers;
+  JobEventCount& event = (workerThreadNumber == 0 && workerThreadCount > 1) ? *expressWorkerEvent : *workerEvent;
 
-  while(workerThreadActive[workerThreadNumber]) {
-    Job* job = nullptr;
+  currentWorkerThreadNumber = (int32_t) workerThreadNumber;
 
-    size_t jobCount = jobQueue.size();        
-    if(jobCount > 0) {
-      workerThreadMutex->Lock();
-
-      if(workerThreadNumber == 0 && workerThreadCount > 1) {
-        // This thread is designated as an "express lane" for jobs that perform quickly.
-        for(auto& currJob: jobQueue) {
-          if(currJob->type == JobType::Express) {
-            job = currJob;
-            jobQueue.remove(currJob);
-            jobsInProgress++;
-            break;
-          }
-        }
+  while(workerThreadActive) {
+    Job* job = FindWorkerJob(workerThreadNumber);
+    if(!job) {
+      uint32_t key = event.PrepareWait();
+      job = FindWorkerJob(workerThreadNumber);
+      if(job) {
+        event.CancelWait();
       }
       else {
-        if(jobQueue.size() > 0) {
-          job = jobQueue.front();
-          jobQueue.pop_front();
-          jobsInProgress++;
-        }
+        event.Wait(key, workerThreadActive);
+        workerWakeups++;
+        continue;
       }
-
-      workerThreadMutex->Unlock();
     }
 
-    if(job) {
-      if(job->callback) {
-        job->callback(*job);
-      }
-      job->completed = true;
+    job->Execute();
+    jobsExecuted++;
+  }
 
-      workerThreadMutex->Lock();
-      jobCompletedStack.push_back(job);
-      if(jobsInProgress > 0) {
-        jobsInProgress--;
-      }
-      workerThreadMutex->Unlock();
+  currentWorkerThreadNumber = -1;
+
+  return nullptr;
+}
 
-      Thread::Yield();
+void* ogalib::JobIOWorkerThread(void* param) {
+  while(workerThreadActive) {
+    Job* job = ioJobQueue->Pop();
+    if(!job) {
+      uint32_t key = ioWorkerEvent->PrepareWait();
+      job = ioJobQueue->Pop();
+      if(job) {
+        ioWorkerEvent->CancelWait();
+      }
+      else {
+        ioWorkerEvent->Wait(key, workerThreadActive);
+        continue;
+      }
     }
 
-    workerThreadCondition[workerThreadNumber]->Wait(workerThreadWait[workerThreadNumber]);
+    job->Execute();
+    ioJobsExecuted++;
   }
 
   return nullptr;
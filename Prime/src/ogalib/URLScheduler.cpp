@@ -0,0 +1,346 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/ogalib.h>
+#include <ogalib/URLScheduler.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class URLRequest {
+public:
+
+  URLScheduler* scheduler;
+  std::string host;
+  JobPriority priority;
+  CancelToken cancel;
+  JobFunction callback;
+  JobFunction response;
+  std::chrono::steady_clock::time_point queuedTime;
+  size_t cancelID;
+  bool started;
+  bool holdsSlot;
+  std::atomic<bool> finished;
+
+public:
+
+  URLRequest(URLScheduler* scheduler, const std::string& host, JobPriority priority, const CancelToken& cancel, JobFunction callback, JobFunction response):
+  scheduler(scheduler),
+  host(host),
+  priority(priority),
+  cancel(cancel),
+  callback(std::move(callback)),
+  response(std::move(response)),
+  queuedTime(std::chrono::steady_clock::now()),
+  cancelID(0),
+  started(false),
+  holdsSlot(false),
+  finished(false) {
+
+  }
+
+};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+bool URLRequestHandle::IsStarted() const {
+  if(!request)
+    return false;
+
+  request->scheduler->mutex.Lock();
+  bool started = request->started;
+  request->scheduler->mutex.Unlock();
+
+  return started;
+}
+
+JobPriority URLRequestHandle::GetPriority() const {
+  if(!request)
+    return JobPriority::Normal;
+
+  request->scheduler->mutex.Lock();
+  JobPriority priority = request->priority;
+  request->scheduler->mutex.Unlock();
+
+  return priority;
+}
+
+void URLRequestHandle::SetPriority(JobPriority priority) const {
+  if(request) {
+    request->scheduler->SetPriority(request, priority);
+  }
+}
+
+URLScheduler::URLScheduler(size_t maxRequests, size_t maxRequestsPerHost, size_t foregroundReserved, size_t prefetchShare):
+mutex("ogalib::URLScheduler mutex"),
+active(0),
+maxRequests(std::max<size_t>(maxRequests, 1)),
+maxRequestsPerHost(std::max<size_t>(maxRequestsPerHost, 1)),
+foregroundReserved(std::min(foregroundReserved, this->maxRequests - 1)),
+prefetchShare(std::max<size_t>(prefetchShare, 1)),
+foregroundSincePrefetch(0),
+reprioritized(0),
+cancelled(0) {
+  for(size_t i = 0; i < 3; i++) {
+    started[i] = 0;
+    waitTime[i] = 0.0;
+    maxWaitTime[i] = 0.0;
+  }
+}
+
+URLScheduler::~URLScheduler() {
+  ogalibAssert(queues[0].empty() && queues[1].empty() && queues[2].empty(), "URL requests are still queued.");
+}
+
+URLRequestHandle URLScheduler::Schedule(const std::string& url, JobPriority priority, const CancelToken& cancel, JobFunction callback, JobFunction response) {
+  URLRequestHandle handle;
+  handle.request = std::make_shared<URLRequest>(this, GetHostKey(url), priority, cancel, std::move(callback), std::move(response));
+
+  // Taken out of its queue as soon as it's cancelled, rather than whenever the next request is dispatched.
+  std::weak_ptr<URLRequest> weakRequest = handle.request;
+  handle.request->cancelID = cancel.OnCancel([weakRequest]() {
+    if(auto request = weakRequest.lock()) {
+      request->scheduler->Cancelled(request);
+    }
+  });
+
+  mutex.Lock();
+  queues[(size_t) priority].push_back(handle.request);
+  mutex.Unlock();
+
+  Dispatch();
+
+  return handle;
+}
+
+json URLScheduler::GetStats() {
+  static const char* priorityNames[] = {"low", "normal", "high"};
+
+  json stats;
+
+  mutex.Lock();
+  stats["active"] = active;
+  stats["maxRequests"] = maxRequests;
+  stats["maxRequestsPerHost"] = maxRequestsPerHost;
+  stats["hosts"] = hostActive.size();
+  stats["reprioritized"] = reprioritized;
+  stats["cancelled"] = cancelled;
+
+  for(size_t i = 0; i < 3; i++) {
+    json priorityStats;
+    priorityStats["queued"] = queues[i].size();
+    priorityStats["started"] = started[i];
+    priorityStats["waitTime"] = started[i] > 0 ? waitTime[i] / started[i] : 0.0;
+    priorityStats["maxWaitTime"] = maxWaitTime[i];
+    stats[priorityNames[i]] = priorityStats;
+  }
+  mutex.Unlock();
+
+  return stats;
+}
+
+std::string URLScheduler::GetHostKey(const std::string& url) {
+  size_t hostStart = url.find("://");
+  hostStart = hostStart == url.npos ? 0 : hostStart + 3;
+
+  size_t hostEnd = url.find_first_of("/?#", hostStart);
+  std::string host = url.substr(0, hostEnd);
+  std::transform(host.begin(), host.end(), host.begin(), [](char c) {return (char) tolower(c);});
+
+  return host;
+}
+
+void URLScheduler::Dispatch() {
+  std::vector<std::shared_ptr<URLRequest>> requests;
+
+  mutex.Lock();
+  while(auto request = TakeNext()) {
+    requests.push_back(request);
+  }
+  mutex.Unlock();
+
+  for(auto& request: requests) {
+    Start(request);
+  }
+}
+
+std::shared_ptr<URLRequest> URLScheduler::TakeNext() {
+  size_t prefetchLimit = maxRequests - foregroundReserved;
+
+  if(foregroundSincePrefetch >= prefetchShare) {
+    if(auto request = TakeFrom(JobPriority::Low, prefetchLimit))
+      return request;
+  }
+
+  if(auto request = TakeFrom(JobPriority::High, maxRequests))
+    return request;
+
+  if(auto request = TakeFrom(JobPriority::Normal, maxRequests))
+    return request;
+
+  return TakeFrom(JobPriority::Low, prefetchLimit);
+}
+
+std::shared_ptr<URLRequest> URLScheduler::TakeFrom(JobPriority priority, size_t limit) {
+  auto& queue = queues[(size_t) priority];
+
+  for(auto it = queue.begin(); it != queue.end(); ++it) {
+    auto request = *it;
+
+    // Cancelled requests start without a slot, so their responses are called right away.
+    if(request->cancel.IsCancelled()) {
+      queue.erase(it);
+      request->started = true;
+      cancelled++;
+      return request;
+    }
+
+    if(active >= limit)
+      continue;
+
+    auto itHost = hostActive.find(request->host);
+    if(itHost != hostActive.end() && itHost->second >= maxRequestsPerHost)
+      continue;
+
+    queue.erase(it);
+    request->started = true;
+    request->holdsSlot = true;
+    hostActive[request->host]++;
+    active++;
+
+    size_t index = (size_t) priority;
+    double wait = std::chrono::duration<double>(std::chrono::steady_clock::now() - request->queuedTime).count();
+    started[index]++;
+    waitTime[index] += wait;
+    maxWaitTime[index] = std::max(maxWaitTime[index], wait);
+
+    if(priority == JobPriority::Low) {
+      foregroundSincePrefetch = 0;
+    }
+    else if(!queues[(size_t) JobPriority::Low].empty()) {
+      foregroundSincePrefetch++;
+    }
+
+    return request;
+  }
+
+  return nullptr;
+}
+
+void URLScheduler::Start(const std::shared_ptr<URLRequest>& request) {
+  // The slot is given back as soon as the transfer is done, without waiting for the response on the main thread.
+  new Job([request](Job& job) {
+    if(request->callback) {
+      request->callback(job);
+    }
+
+    request->scheduler->Finished(request.get());
+  }, [request](Job& job) {
+    request->scheduler->Finished(request.get());
+
+    if(request->response) {
+      request->response(job);
+    }
+
+    // Handles may outlive the request, so drop anything its callbacks hold on to.
+    request->callback.Reset();
+    request->response.Reset();
+  }, request->cancel, JobType::IO);
+}
+
+void URLScheduler::Finished(URLRequest* request) {
+  if(request->finished.exchange(true))
+    return;
+
+  request->cancel.RemoveOnCancel(request->cancelID);
+
+  mutex.Lock();
+  if(request->holdsSlot) {
+    auto it = hostActive.find(request->host);
+    if(it != hostActive.end() && --it->second == 0) {
+      hostActive.erase(it);
+    }
+
+    active--;
+  }
+  mutex.Unlock();
+
+  Dispatch();
+}
+
+void URLScheduler::Cancelled(const std::shared_ptr<URLRequest>& request) {
+  mutex.Lock();
+  auto& queue = queues[(size_t) request->priority];
+  auto it = std::find(queue.begin(), queue.end(), request);
+  if(request->started || it == queue.end()) {
+    mutex.Unlock();
+    return;
+  }
+
+  queue.erase(it);
+  request->started = true;
+  cancelled++;
+  mutex.Unlock();
+
+  Start(request);
+}
+
+void URLScheduler::SetPriority(const std::shared_ptr<URLRequest>& request, JobPriority priority) {
+  mutex.Lock();
+  if(request->started || request->priority == priority) {
+    mutex.Unlock();
+    return;
+  }
+
+  auto& queue = queues[(size_t) request->priority];
+  auto it = std::find(queue.begin(), queue.end(), request);
+  if(it != queue.end()) {
+    queue.erase(it);
+  }
+
+  request->priority = priority;
+  queues[(size_t) priority].push_back(request);
+  reprioritized++;
+  mutex.Unlock();
+
+  Dispatch();
+}
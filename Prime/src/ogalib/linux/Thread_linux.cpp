@@ -0,0 +1,502 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/ogalib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+#define OGALIB_LINUX_THREAD_NAME_LENGTH 15
+
+////////////////////////////////////////////////////////////////////////////////
+// Structs
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+typedef struct {
+  pthread_mutex_t mutex;
+} ThreadMutexLinux;
+
+typedef struct {
+  pthread_t thread;
+  bool joinable;
+} ThreadLinux;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+} ThreadConditionLinux;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t Thread::mainThreadId = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+void* ThreadEntryFunction(void* param);
+};
+
+static std::string GetLinuxThreadName(const std::string& name);
+static void SetLinuxThreadPreferredCore(pthread_t thread, int preferredCore);
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+ThreadMutex::ThreadMutex(const char* name, bool recursive):
+native(nullptr) {
+  this->name = name ? name : "";
+
+  ThreadMutexLinux* nativeLinux = new ThreadMutexLinux;
+  native = nativeLinux;
+
+  if(native) {
+    int err;
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, recursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL);
+
+    err = pthread_mutex_init(&nativeLinux->mutex, &attr);
+    ogalibAssert(err == 0, "Error creating thread mutex: pthread_mutex_init, %d", err);
+
+    pthread_mutexattr_destroy(&attr);
+
+    (void) err;
+  }
+  else {
+    ogalibAssert(false, "Could not allocate native data for thread mutex.");
+  }
+}
+
+ThreadMutex::~ThreadMutex() {
+  if(native) {
+    ThreadMutexLinux* nativeLinux = static_cast<ThreadMutexLinux*>(native);
+
+    int err = pthread_mutex_destroy(&nativeLinux->mutex);
+    ogalibAssert(err == 0, "Error deleting thread mutex: pthread_mutex_destroy, %d", err);
+
+    delete nativeLinux;
+    native = nullptr;
+
+    (void) err;
+  }
+}
+
+bool ThreadMutex::Lock() {
+  if(native) {
+    ThreadMutexLinux* nativeLinux = static_cast<ThreadMutexLinux*>(native);
+    return pthread_mutex_lock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadMutex::TryLock() {
+  if(native) {
+    ThreadMutexLinux* nativeLinux = static_cast<ThreadMutexLinux*>(native);
+    return pthread_mutex_trylock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadMutex::Unlock() {
+  if(native) {
+    ThreadMutexLinux* nativeLinux = static_cast<ThreadMutexLinux*>(native);
+    return pthread_mutex_unlock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+Thread::Thread(std::function<void*(void*)> entry, void* param, const char* name):
+entry(entry),
+param(param),
+result(nullptr),
+native(nullptr),
+threadId(0),
+priority(0.0f),
+preferredCore(-1),
+started(false) {
+  this->name = name ? name : "";
+
+  ThreadLinux* nativeLinux = new ThreadLinux;
+  native = nativeLinux;
+
+  if(native) {
+    nativeLinux->joinable = false;
+  }
+  else {
+    ogalibAssert(false, "Could not allocate native data for thread.");
+  }
+}
+
+Thread::~Thread() {
+  Join();
+  started = false;
+
+  if(native) {
+    ThreadLinux* nativeLinux = static_cast<ThreadLinux*>(native);
+    delete nativeLinux;
+    native = nullptr;
+  }
+}
+
+bool Thread::Start() {
+  if(started)
+    return false;
+
+  if(native) {
+    ThreadLinux* nativeLinux = static_cast<ThreadLinux*>(native);
+
+    // Mark the thread as started before it runs so a fast entry function can clear the flag.
+    started = true;
+
+    int callResult = pthread_create(&nativeLinux->thread, nullptr, ThreadEntryFunction, this);
+    if(callResult == 0) {
+      nativeLinux->joinable = true;
+
+      if(preferredCore >= 0) {
+        SetLinuxThreadPreferredCore(nativeLinux->thread, preferredCore);
+      }
+    }
+    else {
+      started = false;
+    }
+
+    return callResult == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool Thread::Join() {
+  if(native) {
+    ThreadLinux* nativeLinux = static_cast<ThreadLinux*>(native);
+
+    if(nativeLinux->joinable) {
+      int callResult = pthread_join(nativeLinux->thread, nullptr);
+      nativeLinux->joinable = false;
+      return callResult == 0;
+    }
+    else {
+      return false;
+    }
+  }
+  else {
+    return false;
+  }
+}
+
+void Thread::SetPriority(float priority) {
+  // Regular Linux threads all share the SCHED_OTHER policy, which has no per-thread priority levels.
+  this->priority = priority;
+}
+
+void Thread::SetPreferredCore(size_t core) {
+  preferredCore = (int) core;
+
+  if(native) {
+    ThreadLinux* nativeLinux = static_cast<ThreadLinux*>(native);
+
+    if(nativeLinux->joinable) {
+      SetLinuxThreadPreferredCore(nativeLinux->thread, preferredCore);
+    }
+  }
+}
+
+bool Thread::IsMainThread() {
+  return mainThreadId == GetCurrentThreadId();
+}
+
+void Thread::Yield() {
+  sched_yield();
+}
+
+void Thread::Sleep(double duration) {
+  struct timespec ts;
+  ts.tv_sec = (time_t) duration;
+  ts.tv_nsec = (long) ((duration - (double) ts.tv_sec) * 1000000000.0);
+
+  while(nanosleep(&ts, &ts) != 0) {
+
+  }
+}
+
+size_t Thread::GetDeviceThreadCount() {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+  if(count < 1)
+    count = 1;
+
+  return (size_t) count;
+}
+
+int64_t Thread::GetCurrentThreadId() {
+  return (int64_t) syscall(SYS_gettid);
+}
+
+void Thread::InitGlobal() {
+  mainThreadId = Thread::GetCurrentThreadId();
+}
+
+void Thread::ShutdownGlobal() {
+
+}
+
+ThreadCondition::ThreadCondition(const char* name):
+native(nullptr) {
+  this->name = name ? name : "";
+
+  ThreadConditionLinux* nativeLinux = new ThreadConditionLinux;
+  native = nativeLinux;
+
+  if(native) {
+    int err;
+
+    err = pthread_mutex_init(&nativeLinux->mutex, nullptr);
+    ogalibAssert(err == 0, "Error creating thread mutex: pthread_mutex_init, %d", err);
+
+    err = pthread_cond_init(&nativeLinux->condition, nullptr);
+    ogalibAssert(err == 0, "Error creating thread condition: pthread_cond_init, %d", err);
+
+    (void) err;
+  }
+}
+
+ThreadCondition::~ThreadCondition() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    int err;
+
+    err = pthread_cond_destroy(&nativeLinux->condition);
+    ogalibAssert(err == 0, "Error deleting thread condition: pthread_cond_destroy, %d", err);
+
+    err = pthread_mutex_destroy(&nativeLinux->mutex);
+    ogalibAssert(err == 0, "Error deleting thread mutex: pthread_mutex_destroy, %d", err);
+
+    delete nativeLinux;
+    native = nullptr;
+
+    (void) err;
+  }
+}
+
+bool ThreadCondition::LockMutex() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_mutex_lock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::TryLockMutex() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_mutex_trylock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::UnlockMutex() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_mutex_unlock(&nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::Signal() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_cond_signal(&nativeLinux->condition) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::SignalAll() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_cond_broadcast(&nativeLinux->condition) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::Wait() {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+    return pthread_cond_wait(&nativeLinux->condition, &nativeLinux->mutex) == 0;
+  }
+  else {
+    return false;
+  }
+}
+
+bool ThreadCondition::Wait(double duration) {
+  if(native) {
+    ThreadConditionLinux* nativeLinux = static_cast<ThreadConditionLinux*>(native);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    long long nsec = (long long) ts.tv_nsec + (long long) (duration * 1000000000.0);
+    ts.tv_sec += (time_t) (nsec / 1000000000LL);
+    ts.tv_nsec = (long) (nsec % 1000000000LL);
+
+    int err = pthread_cond_timedwait(&nativeLinux->condition, &nativeLinux->mutex, &ts);
+    return err == 0 || err == ETIMEDOUT;
+  }
+  else {
+    return false;
+  }
+}
+
+void ThreadCondition::Signal(bool& wait) {
+  ThreadConditionLock lock(*this);
+  wait = false;
+  Signal();
+}
+
+void ThreadCondition::Wait(bool& wait) {
+  wait = true;
+
+  ThreadConditionLock lock(*this);
+  while(wait)
+    Wait();
+}
+
+void ThreadCondition::Wait(double duration, bool& wait) {
+  wait = true;
+
+  ThreadConditionLock lock(*this);
+  Wait(duration);
+  wait = false;
+}
+
+void ThreadCondition::ShutdownThread(Thread*& thread) {
+  if(!thread)
+    return;
+
+  while(thread->started) {
+    Signal();
+    if(thread->started) {
+      Thread::Yield();
+    }
+  }
+
+  if(thread) {
+    delete thread;
+    thread = nullptr;
+  }
+}
+
+void ThreadCondition::ShutdownThread(Thread*& thread, bool& wait) {
+  if(!thread)
+    return;
+
+  while(thread->started) {
+    Signal(wait);
+    if(thread->started) {
+      Thread::Yield();
+    }
+  }
+
+  if(thread) {
+    delete thread;
+    thread = nullptr;
+  }
+}
+
+void* ogalib::ThreadEntryFunction(void* param) {
+  Thread* thread = (Thread*) param;
+  thread->threadId = ogalib::Thread::GetCurrentThreadId();
+
+  if(!thread->name.empty()) {
+    pthread_setname_np(pthread_self(), GetLinuxThreadName(thread->name).c_str());
+  }
+
+  if(thread->entry) {
+    thread->result = thread->entry(thread->param);
+  }
+
+  thread->started = false;
+
+  return nullptr;
+}
+
+std::string GetLinuxThreadName(const std::string& name) {
+  if(name.length() > OGALIB_LINUX_THREAD_NAME_LENGTH) {
+    return name.substr(0, OGALIB_LINUX_THREAD_NAME_LENGTH);
+  }
+  else {
+    return name;
+  }
+}
+
+void SetLinuxThreadPreferredCore(pthread_t thread, int preferredCore) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET((size_t) preferredCore % Thread::GetDeviceThreadCount(), &cpuSet);
+  pthread_setaffinity_np(thread, sizeof(cpuSet), &cpuSet);
+}
+
+#endif
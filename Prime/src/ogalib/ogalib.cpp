@@ -37,6 +37,10 @@ SOFTWARE.
 #elif defined(__ORBIS__)
 #include <ogalib/ps4/ogalib_ps4.h>
 #endif
+#if defined(__linux__)
+#include <ogalib/linux/ogalib_linux.h>
+#endif
+#include <ogalib/AssetDiskCache.h>
 #include <ogalib/md5/md5.h>
 #include <cctype>
 #include <iomanip>
@@ -75,6 +79,151 @@ static __inline char FromHex(char c) {
   return isdigit(c) ? c - '0' : tolower(c) - 'a' + 10;
 }
 
+static json GetSendURLParams(const json& params);
+static std::string GetMD5String(const std::string& value);
+static std::string GetAssetFormat(const std::string& data);
+static json GetAssetJSON(const AssetCacheItem& item);
+static json GetCancelledJSON();
+static JobPriority GetURLPriority(const json& params, JobPriority defaultPriority);
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+// A GetAssetByURL download shared by every caller of the same URL. It is
+// cancelled once all of its callers have cancelled.
+class AssetDownload: public std::enable_shared_from_this<AssetDownload> {
+private:
+
+  struct Waiter {
+    std::function<void(const json&, const DataBuffer&)> callback;
+    CancelToken cancel;
+    size_t cancelId;
+  };
+
+  std::string url;
+  std::vector<Waiter> waiters;
+  size_t activeWaiters;
+  bool completed;
+
+public:
+
+  CancelToken cancel;
+  JobPriority priority;
+  URLRequestHandle request;
+
+public:
+
+  AssetDownload(const std::string& url):
+  url(url),
+  activeWaiters(0),
+  completed(false),
+  cancel(CancelToken::Create()),
+  priority(JobPriority::Low) {
+
+  }
+
+public:
+
+  // Called with assetCacheMutex locked. Callers without a callback are prefetching, so they only
+  // need the download at low priority.
+  size_t AddWaiter(const std::function<void(const json&, const DataBuffer&)>& callback, const CancelToken& waiterCancel) {
+    waiters.push_back({callback, waiterCancel, 0});
+    activeWaiters++;
+
+    if(callback && priority == JobPriority::Low) {
+      priority = JobPriority::Normal;
+    }
+
+    return waiters.size() - 1;
+  }
+
+  // Called after assetCacheMutex is unlocked, once the request is scheduled or a waiter is added.
+  void UpdatePriority() {
+    ogalibData.assetCacheMutex->Lock();
+    URLRequestHandle useRequest = request;
+    JobPriority usePriority = priority;
+    ogalibData.assetCacheMutex->Unlock();
+
+    if(useRequest.IsValid() && useRequest.GetPriority() < usePriority) {
+      useRequest.SetPriority(usePriority);
+    }
+  }
+
+  // Called after assetCacheMutex is unlocked, since the token calls back right away if it is already cancelled.
+  void WatchWaiter(size_t index, const CancelToken& waiterCancel) {
+    if(!waiterCancel.IsValid())
+      return;
+
+    std::weak_ptr<AssetDownload> weakThis = shared_from_this();
+    size_t cancelId = waiterCancel.OnCancel([weakThis]() {
+      if(auto download = weakThis.lock()) {
+        download->WaiterCancelled();
+      }
+    });
+
+    ogalibData.assetCacheMutex->Lock();
+    if(!completed) {
+      waiters[index].cancelId = cancelId;
+      cancelId = 0;
+    }
+    ogalibData.assetCacheMutex->Unlock();
+
+    waiterCancel.RemoveOnCancel(cancelId);
+  }
+
+  void WaiterCancelled() {
+    ogalibData.assetCacheMutex->Lock();
+    if(completed || activeWaiters == 0 || --activeWaiters > 0) {
+      ogalibData.assetCacheMutex->Unlock();
+      return;
+    }
+
+    // New callers of this URL start a fresh download from here on.
+    Forget();
+    ogalibData.assetCacheMutex->Unlock();
+
+    cancel.Cancel();
+  }
+
+  void Complete(const json& result, const DataBuffer& data) {
+    std::vector<Waiter> completedWaiters;
+
+    ogalibData.assetCacheMutex->Lock();
+    completed = true;
+    completedWaiters.swap(waiters);
+    Forget();
+    ogalibData.assetCacheMutex->Unlock();
+
+    for(auto& waiter: completedWaiters) {
+      waiter.cancel.RemoveOnCancel(waiter.cancelId);
+
+      if(waiter.callback) {
+        if(waiter.cancel.IsCancelled()) {
+          waiter.callback(GetCancelledJSON(), nullptr);
+        }
+        else {
+          waiter.callback(result, data);
+        }
+      }
+    }
+  }
+
+private:
+
+  void Forget() {
+    auto it = ogalibData.assetCacheInProgress.find(url);
+    if(it != ogalibData.assetCacheInProgress.end() && it->second.get() == this) {
+      ogalibData.assetCacheInProgress.erase(it);
+    }
+  }
+
+};
+
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Functions
 ////////////////////////////////////////////////////////////////////////////////
@@ -83,9 +232,24 @@ Data::Data():
 initialized(false),
 encodeURLRequests(false),
 loginInProgress(false),
+loginDone(NULL),
 userId(0),
-token(0) {
+token(0),
+urlScheduler(NULL),
+assetCache(NULL),
+assetCacheMutex(NULL) {
+
+}
+
+void Data::SetLoginInProgress(bool loginInProgress) {
+  this->loginInProgress = loginInProgress;
 
+  if(loginDone) {
+    if(loginInProgress)
+      loginDone->Reset();
+    else
+      loginDone->Set();
+  }
 }
 
 void ogalib::Init(const json& params) {
@@ -102,7 +266,38 @@ void ogalib::Init(const json& params) {
   Thread::InitGlobal();
   Job::InitGlobal();
 
+  size_t urlMaxRequests = OGALIB_URL_MAX_REQUESTS;
+  if(auto it = ogalibData.initParams.find("URLScheduler.MaxRequests")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      urlMaxRequests = (size_t) value.GetUint64();
+    }
+  }
+
+  size_t urlMaxRequestsPerHost = OGALIB_URL_MAX_REQUESTS_PER_HOST;
+  if(auto it = ogalibData.initParams.find("URLScheduler.MaxRequestsPerHost")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      urlMaxRequestsPerHost = (size_t) value.GetUint64();
+    }
+  }
+
+  ogalibData.urlScheduler = new URLScheduler(urlMaxRequests, urlMaxRequestsPerHost, OGALIB_URL_FOREGROUND_RESERVED, OGALIB_URL_PREFETCH_SHARE);
+
   ogalibData.assetCacheMutex = new ThreadMutex();
+  ogalibData.loginDone = new Event("ogalib login done", true);
+
+  size_t assetCacheMaxSize = OGALIB_ASSET_CACHE_MAX_SIZE;
+  if(auto it = ogalibData.initParams.find("AssetCache.MaxSize")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      assetCacheMaxSize = (size_t) value.GetUint64();
+    }
+  }
+
+  ogalibData.assetCache = new AssetCache(assetCacheMaxSize, OGALIB_ASSET_CACHE_SHARD_COUNT);
+
+  InitAssetDiskCache();
 
 #if defined(OGALIB_USING_STEAM)
   InitSteam();
@@ -112,6 +307,10 @@ void ogalib::Init(const json& params) {
   InitPS4();
 #endif
 
+#if defined(__linux__)
+  InitLinux();
+#endif
+
   ogalibData.initialized = true;
 }
 
@@ -123,7 +322,7 @@ void ogalib::Shutdown() {
 
   while(Job::HasJobs()) {
     ogalib::Process();
-    Thread::Yield();
+    Job::WaitForResponses();
   }
 
 #if defined(OGALIB_USING_STEAM)
@@ -134,21 +333,46 @@ void ogalib::Shutdown() {
   ShutdownPS4();
 #endif
 
+#if defined(__linux__)
+  ShutdownLinux();
+#endif
+
+  ShutdownAssetDiskCache();
+
+  if(ogalibData.assetCache) {
+    delete ogalibData.assetCache;
+    ogalibData.assetCache = NULL;
+  }
+
   if(ogalibData.assetCacheMutex) {
     delete ogalibData.assetCacheMutex;
     ogalibData.assetCacheMutex = NULL;
   }
 
+  if(ogalibData.urlScheduler) {
+    delete ogalibData.urlScheduler;
+    ogalibData.urlScheduler = NULL;
+  }
+
+  if(ogalibData.loginDone) {
+    delete ogalibData.loginDone;
+    ogalibData.loginDone = NULL;
+  }
+
   Job::ShutdownGlobal();
 
   ogalibData.initialized = false;
 }
 
 void ogalib::Process() {
+  Process(0.0);
+}
+
+void ogalib::Process(double jobTimeBudget) {
   ogalibRequireInit;
 
   if(Thread::IsMainThread()) {
-    Job::ProcessGlobal();
+    Job::ProcessGlobal(jobTimeBudget);
 
 #if defined(OGALIB_USING_STEAM)
     ProcessSteam();
@@ -192,37 +416,92 @@ void ogalib::SendURL(const std::string& url, const std::function<void(const json
 }
 
 void ogalib::SendURL(const std::string& url, const json& params, const std::function<void(const json&)>& callback) {
+  SendURL(url, params, CancelToken(), callback);
+}
+
+void ogalib::SendURL(const std::string& url, const json& params, const std::function<void(const json&, const DataBuffer&)>& callback) {
+  SendURL(url, params, CancelToken(), callback);
+}
+
+URLRequestHandle ogalib::SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&)>& callback) {
   ogalibRequireInit;
 
-  new Job([=](Job& job) {
-    json useParams = ogalibData.globalSendURLParams;
-    useParams += params;
+  return ogalibData.urlScheduler->Schedule(url, GetURLPriority(params, JobPriority::Normal), cancel, [=](Job& job) {
+    json useParams = GetSendURLParams(params);
 
-    if(auto it = useParams.find("usesAPIKey")) {
-      auto& value = it.value();
-      if(value.IsBool() && value.GetBool()) {
-        if(ogalibData.apiKey.length() > 0) {
-          useParams["authorizationBearerToken"] = ogalibData.apiKey;
-        }
-      }
+    job.data["sendURLResult"] = SendURL(url.c_str(), useParams, job.data, cancel);
+  }, [=](Job& job) {
+    if(job.IsCancelled() && !job.data.IsAllocated()) {
+      job.data["error"] = "Cancelled.";
+      job.data["cancelled"] = true;
     }
 
-    job.data["sendURLResult"] = SendURL(url.c_str(), useParams, job.data);
-  }, [=](Job& job) {
     if(callback) {
       callback(job.data);
     }
   });
 }
 
+URLRequestHandle ogalib::SendURL(const std::string& url, const json& params, const CancelToken& cancel, const std::function<void(const json&, const DataBuffer&)>& callback) {
+  ogalibRequireInit;
+
+  auto response = std::make_shared<DataBuffer>();
+
+  return ogalibData.urlScheduler->Schedule(url, GetURLPriority(params, JobPriority::Normal), cancel, [=](Job& job) {
+    json useParams = GetSendURLParams(params);
+
+    auto responseData = std::make_shared<std::string>();
+    bool sendURLResult = SendURL(url.c_str(), useParams, job.data, *responseData, cancel);
+    job.data["sendURLResult"] = sendURLResult;
+    if(sendURLResult) {
+      *response = responseData;
+    }
+  }, [=](Job& job) {
+    if(job.IsCancelled() && !job.data.IsAllocated()) {
+      job.data["error"] = "Cancelled.";
+      job.data["cancelled"] = true;
+    }
+
+    if(callback) {
+      callback(job.data, *response);
+    }
+  });
+}
+
+bool ogalib::SendURL(const std::string& url, const json& params, json& result, const CancelToken& cancel) {
+  std::string response;
+
+  bool resultValue = SendURL(url, params, result, response, cancel);
+  if(resultValue) {
+    result["response"] = response;
+  }
+
+  return resultValue;
+}
+
 void ogalib::GetAssetByURL(const std::string& url, std::function<void(const json&)> callback) {
+  if(callback) {
+    GetAssetByURL(url, [=](const json& asset, const DataBuffer&) {
+      callback(asset);
+    });
+  }
+  else {
+    GetAssetByURL(url, std::function<void(const json&, const DataBuffer&)>());
+  }
+}
+
+void ogalib::GetAssetByURL(const std::string& url, std::function<void(const json&, const DataBuffer&)> callback) {
+  GetAssetByURL(url, CancelToken(), callback);
+}
+
+void ogalib::GetAssetByURL(const std::string& url, const CancelToken& cancel, std::function<void(const json&, const DataBuffer&)> callback) {
   ogalibRequireInit;
 
   if(url.empty()) {
     if(callback) {
       callback({
         {"error", "Bad URL."},
-        });
+        }, nullptr);
     }
 
     return;
@@ -230,148 +509,159 @@ void ogalib::GetAssetByURL(const std::string& url, std::function<void(const json
   else {
     std::string useURL(url);
 
-    if(auto it = ogalibData.assetCache.find(useURL)) {
+    AssetCacheItem item;
+    if(ogalibData.assetCache->Get(useURL, item)) {
       if(callback) {
-        callback(it);
+        callback(GetAssetJSON(item), item.data);
       }
 
       return;
     }
-    else {
-      ogalibData.assetCacheMutex->Lock();
-      bool inProgress = ogalibData.assetCacheInProgress.find(useURL);
-      ogalibData.assetCacheMutex->Unlock();
 
-      if(inProgress) {
-        new Job([=](Job& job) {
-          while(true) {
-            ogalibData.assetCacheMutex->Lock();
-            bool cacheInProgress = ogalibData.assetCacheInProgress.find(useURL);
-            ogalibData.assetCacheMutex->Unlock();
+    if(cancel.IsCancelled()) {
+      if(callback) {
+        callback(GetCancelledJSON(), nullptr);
+      }
 
-            if(!cacheInProgress) {
-              break;
-            }
+      return;
+    }
 
-            Thread::Yield();
-          }
-        }, [=](Job& job) {
-          if(auto it = ogalibData.assetCache.find(useURL)) {
-            if(callback) {
-              callback(it);
-            }
-          }
-          else {
-            if(callback) {
-              callback({
-                {"error", "Asset not found."},
-                });
-            }
-          }
-        });
+    // Callers of a URL that is already downloading wait on that download instead of starting another.
+    // A download that every caller has cancelled is left to finish on its own and a new one is started.
+    ogalibData.assetCacheMutex->Lock();
+    auto itInProgress = ogalibData.assetCacheInProgress.find(useURL);
+    if(itInProgress != ogalibData.assetCacheInProgress.end() && !itInProgress->second->cancel.IsCancelled()) {
+      auto download = itInProgress->second;
+      size_t waiterIndex = download->AddWaiter(callback, cancel);
+      ogalibData.assetCacheMutex->Unlock();
 
-        return;
-      }
+      download->WatchWaiter(waiterIndex, cancel);
+      download->UpdatePriority();
+      return;
     }
 
-    ogalibData.assetCacheMutex->Lock();
-    ogalibData.assetCacheInProgress[useURL] = true;
+    auto download = std::make_shared<AssetDownload>(useURL);
+    ogalibData.assetCacheInProgress[useURL] = download;
+    size_t waiterIndex = download->AddWaiter(callback, cancel);
+    JobPriority priority = download->priority;
+    ogalibData.assetCacheMutex->Unlock();
 
-    SendURL(url, [=](const json& data) {
-      ogalibData.assetCacheMutex->Lock();
-      ogalibData.assetCacheInProgress.erase(useURL);
-      ogalibData.assetCacheMutex->Unlock();
+    download->WatchWaiter(waiterIndex, cancel);
+
+    std::string md5URL = GetMD5String(useURL);
+    auto response = std::make_shared<DataBuffer>();
+
+    URLRequestHandle request = ogalibData.urlScheduler->Schedule(useURL, priority, download->cancel, [=](Job& job) {
+      json params;
+      AssetDiskCacheEntry entry;
+      std::string cachedResponse;
+      bool cached = ReadAssetDiskCache(md5URL, entry, cachedResponse);
 
-      json asset;
-      asset["url"] = std::string(useURL);
+      // Revalidate the disk copy so an unchanged asset is not downloaded again.
+      if(cached) {
+        json headers;
 
-      uint8_t md5[16];
-      char md5Str[32 + 1];
+        if(!entry.etag.empty()) {
+          headers["If-None-Match"] = entry.etag;
+        }
 
-      MD5_CTX ctx;
-      MD5_Init(&ctx);
-      MD5_Update(&ctx, useURL.c_str(), (uint32_t) useURL.length());
-      MD5_Final(md5, &ctx);
+        if(!entry.lastModified.empty()) {
+          headers["If-Modified-Since"] = entry.lastModified;
+        }
 
-      for(uint32_t i = 0; i < 16; i++) {
-        sprintf(&md5Str[i * 2], "%02x", md5[i]);
+        params["headers"] = headers;
       }
-      md5Str[32] = 0;
 
-      asset["md5_url"] = std::string(md5Str);
+      auto responseData = std::make_shared<std::string>();
+      SendURL(useURL, GetSendURLParams(params), job.data, *responseData, download->cancel);
 
-      if(auto it = data.find("error")) {
-        if(callback) {
-          callback({
-            {"error", it.cstr()},
-            });
+      if(download->cancel.IsCancelled())
+        return;
+
+      int statusCode = job.data["statusCode"].GetInt();
+
+      if(cached && (statusCode == 304 || statusCode == 0)) {
+        // Not modified, or the server could not be reached.
+        if(auto it = job.data.find("error")) {
+          job.data.erase(it);
         }
+
+        responseData->swap(cachedResponse);
+        *response = responseData;
       }
-      else {
-        if(auto it = data.find("response")) {
-          std::string response = it.GetString();
-          size_t fileDataSize = response.size();
-          bool foundAsset = false;
-
-          // Check for GLB.
-          if(!foundAsset) {
-            uint8_t header[12];
-            if(fileDataSize >= sizeof(header)) {
-              memcpy(header, &response[0], sizeof(header));
-
-              if(memcmp(&header, "glTF", 4) == 0) {
-                //uint32_t readVersion = header[4] | (header[5] << 8) | (header[6] << 16) | (header[7] << 24);
-                uint32_t readSize = header[8] | (header[9] << 8) | (header[10] << 16) | (header[11] << 24);
-
-                if(readSize == fileDataSize) {
-                  asset["gltf"] = response;
-                  foundAsset = true;
-                }
-              }
-            }
-          }
+      else if(statusCode == 200) {
+        *response = responseData;
 
-          // Check for PNG.
-          if(!foundAsset) {
-            uint8_t header[8];
-            if(fileDataSize >= sizeof(header)) {
-              memcpy(header, &response[0], sizeof(header));
+        if(IsAssetDiskCacheEnabled()) {
+          AssetDiskCacheEntry newEntry;
+          newEntry.url = useURL;
 
-              static unsigned char pngSignature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
-              if(!memcmp(header, pngSignature, 8)) {
-                asset["png"] = response;
-                foundAsset = true;
-              }
-            }
+          if(auto itHeaders = job.data.find("headers")) {
+            newEntry.etag = itHeaders["etag"].GetString();
+            newEntry.lastModified = itHeaders["last-modified"].GetString();
           }
 
-          if(foundAsset) {
-            ogalibData.assetCache[useURL] = asset;
+          WriteAssetDiskCache(md5URL, newEntry, responseData->data(), responseData->size());
+        }
+      }
 
-            if(callback) {
-              callback(asset);
-            }
-          }
-          else {
-            if(callback) {
-              callback({
-                {"error", "Did not find an asset."},
-                });
-            }
-          }
+      if(*response) {
+        job.data["format"] = GetAssetFormat(**response);
+      }
+    }, [=](Job& job) {
+      const json& data = job.data;
+
+      if(download->cancel.IsCancelled() && !*response) {
+        download->Complete(GetCancelledJSON(), nullptr);
+      }
+      else if(auto it = data.find("error")) {
+        download->Complete({
+          {"error", it.cstr()},
+          }, nullptr);
+      }
+      else if(!*response) {
+        download->Complete({
+          {"error", "Did not receive a response."},
+          }, nullptr);
+      }
+      else {
+        AssetCacheItem item;
+        item.url = useURL;
+        item.md5URL = md5URL;
+        item.format = job.data["format"].GetString();
+        item.data = *response;
+
+        if(!item.format.empty()) {
+          ogalibData.assetCache->Set(useURL, item);
+
+          download->Complete(GetAssetJSON(item), item.data);
         }
         else {
-          if(callback) {
-            callback({
-              {"error", "Did not receive a response."},
-              });
-          }
+          download->Complete({
+            {"error", "Did not find an asset."},
+            }, nullptr);
         }
       }
     });
+
+    ogalibData.assetCacheMutex->Lock();
+    download->request = request;
+    ogalibData.assetCacheMutex->Unlock();
+
+    download->UpdatePriority();
   }
+}
 
-  ogalibData.assetCacheMutex->Unlock();
+json ogalib::GetAssetCacheStats() {
+  ogalibRequireInit;
+
+  return ogalibData.assetCache->GetStats();
+}
+
+json ogalib::GetURLSchedulerStats() {
+  ogalibRequireInit;
+
+  return ogalibData.urlScheduler->GetStats();
 }
 
 void ogalib::Login(std::function<void(const json&)> callback) {
@@ -385,7 +675,7 @@ void ogalib::Login(std::function<void(const json&)> callback) {
     }
   }
   else {
-    ogalibData.loginInProgress = true;
+    ogalibData.SetLoginInProgress(true);
 
     new Job(nullptr, [=](Job& cb) {
       ogalibAssert(ogalibData.initialized, "ogalib is not initialized.");
@@ -421,16 +711,14 @@ void ogalib::WaitForLogin(std::function<void()> callback) {
   ogalibRequireInit;
 
   if(IsLoginInProgress()) {
-    new Job([=](Job& cb) {
-      while(IsLoginInProgress()) {
-        Thread::Sleep(0.5);
-        Thread::Yield();
-      }
-    }, [=](Job& cb) {
-      if(callback) {
-        callback();
-      }
-    }, JobType::Independent);
+    // Called back through a job so the callback still runs on the main thread, on the next Process.
+    ogalibData.loginDone->Then([=]() {
+      new Job(nullptr, [=](Job& cb) {
+        if(callback) {
+          callback();
+        }
+      });
+    });
   }
   else {
     if(callback) {
@@ -959,6 +1247,138 @@ std::string ogalib::DecodeURL(const char* f) {
   return escaped.str();
 }
 
+JobPriority GetURLPriority(const json& params, JobPriority defaultPriority) {
+  if(auto it = params.find("priority")) {
+    std::string priority = it.GetString();
+    if(priority == "low") {
+      return JobPriority::Low;
+    }
+    else if(priority == "normal") {
+      return JobPriority::Normal;
+    }
+    else if(priority == "high") {
+      return JobPriority::High;
+    }
+  }
+
+  return defaultPriority;
+}
+
+json GetCancelledJSON() {
+  return {
+    {"error", "Cancelled."},
+    {"cancelled", true},
+    };
+}
+
+json GetSendURLParams(const json& params) {
+  json useParams = ogalibData.globalSendURLParams;
+  useParams += params;
+
+  if(auto it = useParams.find("usesAPIKey")) {
+    auto& value = it.value();
+    if(value.IsBool() && value.GetBool()) {
+      if(ogalibData.apiKey.length() > 0) {
+        useParams["authorizationBearerToken"] = ogalibData.apiKey;
+      }
+    }
+  }
+
+  return useParams;
+}
+
+std::string GetMD5String(const std::string& value) {
+  uint8_t md5[16];
+  char md5Str[32 + 1];
+
+  MD5_CTX ctx;
+  MD5_Init(&ctx);
+  MD5_Update(&ctx, value.c_str(), (uint32_t) value.length());
+  MD5_Final(md5, &ctx);
+
+  for(uint32_t i = 0; i < 16; i++) {
+    sprintf(&md5Str[i * 2], "%02x", md5[i]);
+  }
+  md5Str[32] = 0;
+
+  return std::string(md5Str);
+}
+
+std::string GetAssetFormat(const std::string& data) {
+  size_t dataSize = data.size();
+
+  // Check for GLB.
+  if(dataSize >= 12) {
+    const uint8_t* header = (const uint8_t*) data.data();
+
+    if(memcmp(header, "glTF", 4) == 0) {
+      //uint32_t readVersion = header[4] | (header[5] << 8) | (header[6] << 16) | (header[7] << 24);
+      uint32_t readSize = header[8] | (header[9] << 8) | (header[10] << 16) | (header[11] << 24);
+
+      if(readSize == dataSize) {
+        return "gltf";
+      }
+    }
+  }
+
+  // Check for PNG.
+  if(dataSize >= 8) {
+    static unsigned char pngSignature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    if(!memcmp(data.data(), pngSignature, 8)) {
+      return "png";
+    }
+  }
+
+  return std::string();
+}
+
+json GetAssetJSON(const AssetCacheItem& item) {
+  json asset;
+
+  asset["url"] = item.url;
+  asset["md5_url"] = item.md5URL;
+  asset["format"] = item.format;
+  asset["data"] = (const void*) item.data->data();
+  asset["size"] = item.data->size();
+
+  return asset;
+}
+
+void ogalib::ParseURLResponseHeaders(const char* headers, size_t headersSize, json& result) {
+  json useHeaders;
+
+  size_t pos = 0;
+  while(pos < headersSize) {
+    size_t lineEnd = pos;
+    while(lineEnd < headersSize && headers[lineEnd] != '\r' && headers[lineEnd] != '\n') {
+      lineEnd++;
+    }
+
+    std::string line(headers + pos, lineEnd - pos);
+    pos = lineEnd + 1;
+
+    size_t colon = line.find(':');
+    if(colon == std::string::npos || colon == 0)
+      continue;
+
+    std::string name = line.substr(0, colon);
+    for(auto& c: name) {
+      c = (char) std::tolower((unsigned char) c);
+    }
+
+    size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+    size_t valueEnd = line.find_last_not_of(" \t");
+    if(valueStart == std::string::npos) {
+      useHeaders[name] = "";
+    }
+    else {
+      useHeaders[name] = line.substr(valueStart, valueEnd - valueStart + 1);
+    }
+  }
+
+  result["headers"] = useHeaders;
+}
+
 void ogalib::AssertCore(const char* file, uint32_t line, const char* f, ...) {
   va_list ap, ap2;
   volatile int wait = 1;
@@ -226,7 +226,7 @@ void ogalib::LoginUsingPS4(std::function<void(const json&)> callback) {
 
       std::string url = string_printf("%s/Login/v1/%s", ogalibData.baseAPI.c_str(), params.c_str()).c_str();
       SendURL(url.c_str(), sendURLParams, [=](const json& response) {
-        ogalibData.loginInProgress = false;
+        ogalibData.SetLoginInProgress(false);
 
         if(auto it = response.find("error")) {
           if(callback) {
@@ -316,7 +316,7 @@ void ogalib::LoginUsingPS4(std::function<void(const json&)> callback) {
       });
     }
     else {
-      ogalibData.loginInProgress = false;
+      ogalibData.SetLoginInProgress(false);
 
       if(callback) {
         callback({
@@ -324,7 +324,7 @@ void ogalib::LoginUsingPS4(std::function<void(const json&)> callback) {
         });
       }
     }
-  });
+  }, JobType::IO);
 }
 
 bool ogalib::SendURL(const char* url, const json& params, json& result, std::string apiKey) {
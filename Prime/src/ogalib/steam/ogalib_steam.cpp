@@ -126,7 +126,7 @@ void ogalib::ProcessSteam() {
       sendURLParams["usesAPIKey"] = true;
 
       SendURL(url.c_str(), sendURLParams, [=](const json& response) {
-        ogalibData.loginInProgress = false;
+        ogalibData.SetLoginInProgress(false);
         auto callback = ogalibDataSteam.authSessionTicketCallback;
         ogalibDataSteam.authSessionTicketCallback = nullptr;
 
@@ -220,7 +220,7 @@ void ogalib::ProcessSteam() {
     }
     else if(ogalibDataSteam.authSessionTicketState == DataSteamAuthSessionTicketStateError) {
       ogalibDataSteam.authSessionTicketState = DataSteamAuthSessionTicketStateNone;
-      ogalibData.loginInProgress = false;
+      ogalibData.SetLoginInProgress(false);
       auto callback = ogalibDataSteam.authSessionTicketCallback;
       ogalibDataSteam.authSessionTicketCallback = nullptr;
       if(callback) {
@@ -249,7 +249,7 @@ void ogalib::LoginUsingSteam(std::function<void(const json&)> callback) {
     ogalibDataSteam.authSessionTicketHandle = steamUser->GetAuthSessionTicket(ogalibDataSteam.authSessionTicket, sizeof(ogalibDataSteam.authSessionTicket), &ogalibDataSteam.authSessionTicketSize, NULL);
     if(ogalibDataSteam.authSessionTicketHandle == k_HAuthTicketInvalid) {
       ogalibDataSteam.authSessionTicketState = DataSteamAuthSessionTicketStateNone;
-      ogalibData.loginInProgress = false;
+      ogalibData.SetLoginInProgress(false);
       auto callback = ogalibDataSteam.authSessionTicketCallback;
       ogalibDataSteam.authSessionTicketCallback = nullptr;
       if(callback) {
@@ -260,7 +260,7 @@ void ogalib::LoginUsingSteam(std::function<void(const json&)> callback) {
     }
   }
   else {
-    ogalibData.loginInProgress = false;
+    ogalibData.SetLoginInProgress(false);
     auto callback = ogalibDataSteam.authSessionTicketCallback;
     ogalibDataSteam.authSessionTicketCallback = nullptr;
     if(callback) {
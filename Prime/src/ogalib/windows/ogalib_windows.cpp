@@ -54,7 +54,7 @@ extern ogalib::Data ogalibData;
 // Functions
 ////////////////////////////////////////////////////////////////////////////////
 
-bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
+bool ogalib::SendURL(const std::string& url, const json& params, json& result, std::string& response, const CancelToken& cancel) {
   if(!ogalibData.initialized) {
     ogalibAssert(false, "ogalib is not initialized.");
     return false;
@@ -70,10 +70,11 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   HINTERNET hSession = NULL;
   HINTERNET hConnect = NULL;
   HINTERNET hRequest = NULL;
-  std::string responseData;
   int statusCode = 0;
   bool secure;
 
+  response.clear();
+
   bool ignoreSSLErrors;
   if(auto it = params.find("ignoreSSLErrors")) {
     auto& value = it.value();
@@ -95,6 +96,12 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   result["statusCode"] = 0;
   result["statusText"] = "";
 
+  if(cancel.IsCancelled()) {
+    result["error"] = "Cancelled.";
+    result["cancelled"] = true;
+    return false;
+  }
+
   int32_t port;  
   if(auto it = params.find("port")) {
     auto& value = it.value();
@@ -167,6 +174,13 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   }
 
   if(hRequest) {
+    if(auto it = params.find("headers")) {
+      for(auto& header: it) {
+        std::string useHeader = string_printf("%s: %s", header.key().GetString(), header.GetString().c_str());
+        WinHttpAddRequestHeaders(hRequest, std::wstring(useHeader.begin(), useHeader.end()).c_str(), (DWORD) -1L, WINHTTP_ADDREQ_FLAG_ADD | WINHTTP_ADDREQ_FLAG_REPLACE);
+      }
+    }
+
     if(auto it = params.find("data")) {
       if(method == "POST") {
         size_t dataSize;
@@ -265,9 +279,25 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
         }
       }
 
+      DWORD headersSize = 0;
+      WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX, WINHTTP_NO_OUTPUT_BUFFER, &headersSize, WINHTTP_NO_HEADER_INDEX);
+      if(GetLastError() == ERROR_INSUFFICIENT_BUFFER && headersSize > 0) {
+        std::wstring headers(headersSize / sizeof(wchar_t), 0);
+        if(WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_RAW_HEADERS_CRLF, WINHTTP_HEADER_NAME_BY_INDEX, &headers[0], &headersSize, WINHTTP_NO_HEADER_INDEX)) {
+          int headersUTF8Size = WideCharToMultiByte(CP_UTF8, 0, headers.c_str(), (int) (headersSize / sizeof(wchar_t)), NULL, 0, NULL, NULL);
+          std::string headersUTF8(headersUTF8Size, 0);
+          WideCharToMultiByte(CP_UTF8, 0, headers.c_str(), (int) (headersSize / sizeof(wchar_t)), &headersUTF8[0], headersUTF8Size, NULL, NULL);
+          ParseURLResponseHeaders(headersUTF8.data(), headersUTF8.size(), result);
+        }
+      }
+
       do {
         dwSize = 0;
-        if(!WinHttpQueryDataAvailable(hRequest, &dwSize)) {
+        if(cancel.IsCancelled()) {
+          result["error"] = "Cancelled.";
+          result["cancelled"] = true;
+        }
+        else if(!WinHttpQueryDataAvailable(hRequest, &dwSize)) {
           result["error"] = string_printf("Error %u in WinHttpQueryDataAvailable.", GetLastError());
         }
         else if(dwSize > 0) {
@@ -284,7 +314,7 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
               break;
             }
             else {
-              responseData.append(pszOutBuffer, dwDownloaded);
+              response.append(pszOutBuffer, dwDownloaded);
             }
 
             delete[] pszOutBuffer;
@@ -313,14 +343,15 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   if(auto itError = result.find("error")) {
     resultValue = false;
   }
-  else if(statusCode == 200) {
-    result["response"] = responseData;
-  }
-  else {
+  else if(statusCode != 200) {
     result["error"] = string_printf("HTTP status code: %d", statusCode);
     resultValue = false;
   }
 
+  if(!resultValue) {
+    response.clear();
+  }
+
   return resultValue;
 }
 
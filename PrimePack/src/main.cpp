@@ -0,0 +1,270 @@
+/*
+Prime Engine
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Prime/Config.h>
+#include <Prime/System/PrimePackFormatWriter.h>
+#include <chrono>
+#include <ctype.h>
+#include <filesystem>
+#include <stdio.h>
+
+using namespace Prime;
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static void PrintUsage() {
+  printf("Usage: PrimePack [options] <input directory> <output file>\n");
+  printf("\n");
+  printf("  -trace <file>             Lay items out in the order listed, one path per line.\n");
+  printf("  -png <file>               Embed the pack in a cPPF chunk of this PNG.\n");
+  printf("  -metadata <name>=<value>  Add pack metadata.\n");
+  printf("  -block-size <bytes>       Uncompressed size of each compressed block (default %d).\n", PrimePackFormatWriterDefaultBlockSize);
+  printf("  -alignment <bytes>        Alignment of stored items (default %d).\n", PrimePackFormatWriterDefaultAlignment);
+  printf("  -level <0-9>              zlib compression level (default %d).\n", PrimePackFormatWriterDefaultCompressionLevel);
+}
+
+static bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if(!file)
+    return false;
+
+  uint8_t buffer[64 * 1024];
+  size_t readSize;
+  while((readSize = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + readSize);
+  }
+
+  bool success = ferror(file) == 0;
+  fclose(file);
+
+  return success;
+}
+
+static bool WriteFileBytes(const std::string& path, const std::vector<uint8_t>& data) {
+  FILE* file = fopen(path.c_str(), "wb");
+  if(!file)
+    return false;
+
+  bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+  success = fclose(file) == 0 && success;
+
+  return success;
+}
+
+static std::string GetItemPath(const std::string& path, const std::string& inputPath) {
+  // Traces may list content URIs, which carry the input directory as a prefix.
+  std::string itemPath = path;
+  if(StartsWith(itemPath, inputPath + "/")) {
+    itemPath = itemPath.substr(inputPath.length());
+  }
+
+  if(itemPath.empty() || itemPath[0] != '/') {
+    itemPath = "/" + itemPath;
+  }
+
+  return itemPath;
+}
+
+static bool ReadTrace(const std::string& path, const std::string& inputPath, std::vector<std::string>& paths) {
+  std::vector<uint8_t> data;
+  if(!ReadFileBytes(path, data))
+    return false;
+
+  std::string text(data.begin(), data.end());
+  size_t pos = 0;
+  while(pos < text.length()) {
+    size_t end = text.find('\n', pos);
+    if(end == std::string::npos) {
+      end = text.length();
+    }
+
+    std::string line = text.substr(pos, end - pos);
+    while(!line.empty() && isspace((unsigned char) line.back())) {
+      line.pop_back();
+    }
+    if(!line.empty() && line[0] != '#') {
+      paths.push_back(GetItemPath(line, inputPath));
+    }
+
+    pos = end + 1;
+  }
+
+  return true;
+}
+
+static double GetElapsed(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Entry
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, const char* const* argv) {
+  std::string inputPath;
+  std::string outputPath;
+  std::string tracePath;
+  std::string pngPath;
+  PrimePackFormatWriter writer;
+
+  for(int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+
+    if(arg == "-trace" && hasValue) {
+      tracePath = argv[++i];
+    }
+    else if(arg == "-png" && hasValue) {
+      pngPath = argv[++i];
+    }
+    else if(arg == "-metadata" && hasValue) {
+      std::string metadata = argv[++i];
+      size_t equals = metadata.find('=');
+      if(equals == std::string::npos) {
+        PrintUsage();
+        return 1;
+      }
+
+      writer.SetMetadata(metadata.substr(0, equals), metadata.substr(equals + 1));
+    }
+    else if(arg == "-block-size" && hasValue) {
+      writer.SetBlockSize((uint32_t) strtoul(argv[++i], nullptr, 10));
+    }
+    else if(arg == "-alignment" && hasValue) {
+      writer.SetAlignment((uint32_t) strtoul(argv[++i], nullptr, 10));
+    }
+    else if(arg == "-level" && hasValue) {
+      writer.SetCompressionLevel(atoi(argv[++i]));
+    }
+    else if(!arg.empty() && arg[0] == '-') {
+      PrintUsage();
+      return 1;
+    }
+    else if(inputPath.empty()) {
+      inputPath = arg;
+    }
+    else if(outputPath.empty()) {
+      outputPath = arg;
+    }
+    else {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if(inputPath.empty() || outputPath.empty()) {
+    PrintUsage();
+    return 1;
+  }
+
+  while(inputPath.length() > 1 && (inputPath.back() == '/' || inputPath.back() == '\\')) {
+    inputPath.pop_back();
+  }
+
+  ogalib::Init();
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::error_code error;
+  std::filesystem::path root(inputPath);
+  for(std::filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+    if(!it->is_regular_file())
+      continue;
+
+    std::string path = it->path().string();
+    std::vector<uint8_t> data;
+    if(!ReadFileBytes(path, data)) {
+      printf("PrimePack: could not read %s\n", path.c_str());
+      ogalib::Shutdown();
+      return 1;
+    }
+
+    writer.AddItem("/" + std::filesystem::relative(it->path(), root).generic_string(), std::move(data));
+  }
+
+  if(error) {
+    printf("PrimePack: could not read directory %s\n", inputPath.c_str());
+    ogalib::Shutdown();
+    return 1;
+  }
+
+  double readTime = GetElapsed(start);
+
+  if(!tracePath.empty()) {
+    std::vector<std::string> paths;
+    if(!ReadTrace(tracePath, std::filesystem::path(inputPath).generic_string(), paths)) {
+      printf("PrimePack: could not read trace %s\n", tracePath.c_str());
+      ogalib::Shutdown();
+      return 1;
+    }
+
+    writer.SetOrder(paths);
+  }
+
+  start = std::chrono::steady_clock::now();
+
+  std::vector<uint8_t> ppf;
+  if(!writer.Write(ppf)) {
+    printf("PrimePack: could not build pack\n");
+    ogalib::Shutdown();
+    return 1;
+  }
+
+  double writeTime = GetElapsed(start);
+
+  if(!pngPath.empty()) {
+    std::vector<uint8_t> png;
+    std::vector<uint8_t> result;
+    if(!ReadFileBytes(pngPath, png) || !PrimePackFormatWriter::EmbedInPNG(png.data(), png.size(), ppf.data(), ppf.size(), result)) {
+      printf("PrimePack: could not embed pack in %s\n", pngPath.c_str());
+      ogalib::Shutdown();
+      return 1;
+    }
+
+    ppf = std::move(result);
+  }
+
+  if(!WriteFileBytes(outputPath, ppf)) {
+    printf("PrimePack: could not write %s\n", outputPath.c_str());
+    ogalib::Shutdown();
+    return 1;
+  }
+
+  const PrimePackFormatWriterStats& stats = writer.GetStats();
+  printf("%zu items, %zu unique, %zu compressed\n", stats.itemCount, stats.uniqueItemCount, stats.compressedItemCount);
+  printf("%llu bytes in, %llu bytes of data, %zu bytes out\n", (unsigned long long) stats.itemSize, (unsigned long long) stats.dataSize, ppf.size());
+  printf("read %.1f ms, pack %.1f ms\n", readTime, writeTime);
+
+  ogalib::Shutdown();
+
+  return 0;
+}
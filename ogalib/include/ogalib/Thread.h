@@ -32,6 +32,7 @@ SOFTWARE.
 
 #include <ogalib/Types.h>
 #include <functional>
+#include <atomic>
 #if defined(_WIN32) || defined(_WIN64)
 #include <mutex>
 #ifdef Yield
@@ -78,7 +79,7 @@ private:
   int64_t threadId;
   float priority;
   int preferredCore;
-  bool started;
+  std::atomic<bool> started;
 
   static int64_t mainThreadId;
 
@@ -0,0 +1,115 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/Job.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class URLRequest;
+class URLScheduler;
+
+class URLRequestHandle {
+friend class URLScheduler;
+private:
+
+  std::shared_ptr<URLRequest> request;
+
+public:
+
+  bool IsValid() const {return request != nullptr;}
+  bool IsStarted() const;
+
+  JobPriority GetPriority() const;
+
+  // Moves a queued request to another priority class. Started requests are not affected.
+  void SetPriority(JobPriority priority) const;
+
+};
+
+// Queues URL requests by priority and starts each one as an IO job once a
+// request slot is free, both overall and for its host. Low priority is
+// prefetch traffic: it gets a share of the starts while foreground requests
+// wait, and never takes the slots reserved for them.
+class URLScheduler {
+friend class URLRequestHandle;
+friend class URLRequest;
+private:
+
+  ThreadMutex mutex;
+  std::deque<std::shared_ptr<URLRequest>> queues[3];
+  std::unordered_map<std::string, size_t> hostActive;
+  size_t active;
+  size_t maxRequests;
+  size_t maxRequestsPerHost;
+  size_t foregroundReserved;
+  size_t prefetchShare;
+  size_t foregroundSincePrefetch;
+
+  size_t started[3];
+  double waitTime[3];
+  double maxWaitTime[3];
+  size_t reprioritized;
+  size_t cancelled;
+
+public:
+
+  URLScheduler(size_t maxRequests, size_t maxRequestsPerHost, size_t foregroundReserved, size_t prefetchShare);
+  ~URLScheduler();
+
+public:
+
+  URLRequestHandle Schedule(const std::string& url, JobPriority priority, const CancelToken& cancel, JobFunction callback, JobFunction response);
+  json GetStats();
+
+  static std::string GetHostKey(const std::string& url);
+
+private:
+
+  void Dispatch();
+  std::shared_ptr<URLRequest> TakeNext();
+  std::shared_ptr<URLRequest> TakeFrom(JobPriority priority, size_t limit);
+  void Start(const std::shared_ptr<URLRequest>& request);
+  void Finished(URLRequest* request);
+  void Cancelled(const std::shared_ptr<URLRequest>& request);
+  void SetPriority(const std::shared_ptr<URLRequest>& request, JobPriority priority);
+
+};
+
+};
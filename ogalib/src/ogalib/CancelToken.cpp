@@ -0,0 +1,125 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/CancelToken.h>
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class CancelState {
+public:
+
+  ThreadMutex mutex;
+  std::atomic<bool> cancelled;
+  std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+  size_t nextCallbackId;
+
+public:
+
+  CancelState(): mutex("ogalib::CancelToken mutex"), cancelled(false), nextCallbackId(1) {}
+
+};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+CancelToken::CancelToken() {
+
+}
+
+CancelToken CancelToken::Create() {
+  CancelToken token;
+  token.state = std::make_shared<CancelState>();
+  return token;
+}
+
+bool CancelToken::IsCancelled() const {
+  return state && state->cancelled.load(std::memory_order_acquire);
+}
+
+void CancelToken::Cancel() const {
+  if(!state)
+    return;
+
+  std::vector<std::pair<size_t, std::function<void()>>> callbacks;
+
+  state->mutex.Lock();
+  if(state->cancelled) {
+    state->mutex.Unlock();
+    return;
+  }
+
+  state->cancelled = true;
+  callbacks.swap(state->callbacks);
+  state->mutex.Unlock();
+
+  for(auto& callback: callbacks) {
+    callback.second();
+  }
+}
+
+size_t CancelToken::OnCancel(const std::function<void()>& callback) const {
+  if(!state || !callback)
+    return 0;
+
+  state->mutex.Lock();
+  if(!state->cancelled) {
+    size_t id = state->nextCallbackId++;
+    state->callbacks.emplace_back(id, callback);
+    state->mutex.Unlock();
+    return id;
+  }
+  state->mutex.Unlock();
+
+  callback();
+  return 0;
+}
+
+void CancelToken::RemoveOnCancel(size_t id) const {
+  if(!state || id == 0)
+    return;
+
+  state->mutex.Lock();
+  for(auto it = state->callbacks.begin(); it != state->callbacks.end(); ++it) {
+    if(it->first == id) {
+      state->callbacks.erase(it);
+      break;
+    }
+  }
+  state->mutex.Unlock();
+}
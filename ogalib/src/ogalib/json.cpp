@@ -461,7 +461,7 @@ json& json::erase(const std::string& v) {
 json& json::erase(const iterator& it) {
   if(&it.js == this) {
     if(doc.IsObject()) {
-      doc.EraseMember(it.value());
+      doc.EraseMember(it.key());
     }
   }
 
@@ -0,0 +1,1424 @@
+/*
+ogalib
+
+MIT License
+
+Copyright (c) 2024 Sean Reid (email@seanreid.ca)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#if defined(__linux__)
+
+////////////////////////////////////////////////////////////////////////////////
+// Includes
+////////////////////////////////////////////////////////////////////////////////
+
+#include <ogalib/ogalib.h>
+#include <ogalib/linux/ogalib_linux.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <deque>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#if defined(OGALIB_USING_OPENSSL)
+#include <signal.h>
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#endif
+
+using namespace ogalib;
+
+////////////////////////////////////////////////////////////////////////////////
+// Defines
+////////////////////////////////////////////////////////////////////////////////
+
+#define OGALIB_LINUX_URL_CONNECT_TIMEOUT          30
+#define OGALIB_LINUX_URL_REQUEST_TIMEOUT          30
+#define OGALIB_LINUX_URL_IDLE_CONNECTION_TIMEOUT  60
+#define OGALIB_LINUX_URL_HTTP_USER_AGENT          "ogalib"
+#define OGALIB_LINUX_URL_RECV_BUFFER_SIZE         (64 * 1024)
+#define OGALIB_LINUX_URL_EPOLL_EVENT_COUNT        64
+#define OGALIB_LINUX_URL_EPOLL_WAIT_TIMEOUT       250
+#define OGALIB_LINUX_URL_MAX_ATTEMPTS             2
+#define OGALIB_LINUX_URL_MAX_REDIRECTS            5
+#define OGALIB_LINUX_URL_CANCELLED                "Cancelled."
+
+#define URLWouldBlock (-1)
+#define URLError      (-2)
+
+////////////////////////////////////////////////////////////////////////////////
+// Enums
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+enum class LinuxURLConnectionState {
+  Connecting,
+  Handshaking,
+  Sending,
+  Receiving,
+  Idle,
+};
+
+enum class LinuxURLParseState {
+  StatusLine,
+  Headers,
+  Body,
+  ChunkSize,
+  ChunkData,
+  ChunkDataEnd,
+  Trailers,
+  Done,
+};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Classes
+////////////////////////////////////////////////////////////////////////////////
+
+namespace ogalib {
+
+class LinuxURLHost;
+
+class LinuxURLAddress {
+public:
+
+  sockaddr_storage address;
+  socklen_t addressSize;
+
+};
+
+class LinuxURLRequest {
+public:
+
+  std::string hostKey;
+  std::string hostName;
+  bool secure;
+  bool ignoreSSLErrors;
+  bool skipResponseData;
+  bool noResponseBody;
+  LinuxURLAddress address;
+  std::string requestData;
+  size_t attempts;
+
+  int statusCode;
+  std::string statusText;
+  std::string responseHeaders;
+  std::string location;
+  std::string response;
+  std::string error;
+  CancelToken cancel;
+
+  ThreadCondition condition;
+  bool wait;
+
+public:
+
+  LinuxURLRequest():
+  secure(false),
+  ignoreSSLErrors(false),
+  skipResponseData(false),
+  noResponseBody(false),
+  attempts(0),
+  statusCode(0),
+  condition("ogalib::SendURL request condition"),
+  wait(true) {
+
+  }
+
+};
+
+class LinuxURLConnection {
+public:
+
+  LinuxURLHost* host;
+  int fd;
+#if defined(OGALIB_USING_OPENSSL)
+  SSL* ssl;
+#endif
+  LinuxURLConnectionState state;
+  LinuxURLRequest* request;
+  size_t requestDataSent;
+  bool reused;
+  bool receivedResponseData;
+  uint32_t events;
+  double deadline;
+
+  LinuxURLParseState parseState;
+  std::string recvBuffer;
+  int64_t contentLength;
+  uint64_t chunkRemaining;
+  bool chunked;
+  bool keepAlive;
+
+public:
+
+  LinuxURLConnection(LinuxURLHost* host, int fd):
+  host(host),
+  fd(fd),
+#if defined(OGALIB_USING_OPENSSL)
+  ssl(nullptr),
+#endif
+  state(LinuxURLConnectionState::Connecting),
+  request(nullptr),
+  requestDataSent(0),
+  reused(false),
+  receivedResponseData(false),
+  events(0),
+  deadline(0.0),
+  parseState(LinuxURLParseState::StatusLine),
+  contentLength(-1),
+  chunkRemaining(0),
+  chunked(false),
+  keepAlive(false) {
+
+  }
+
+};
+
+class LinuxURLHost {
+public:
+
+  std::string key;
+  std::deque<LinuxURLRequest*> pending;
+  std::vector<LinuxURLConnection*> connections;
+
+};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Variables
+////////////////////////////////////////////////////////////////////////////////
+
+extern ogalib::Data ogalibData;
+ogalib::DataLinux ogalibDataLinux;
+
+static int urlEpoll = -1;
+static int urlEvent = -1;
+static std::atomic<bool> urlThreadActive(false);
+static std::atomic<bool> urlCancelPending(false);
+static Thread* urlThread = nullptr;
+static ThreadMutex* urlMutex = nullptr;
+static std::deque<LinuxURLRequest*> urlSubmitted;
+static ThreadMutex* urlAddressMutex = nullptr;
+static std::unordered_map<std::string, LinuxURLAddress> urlAddressCache;
+
+// Only accessed from the URL thread.
+static std::unordered_map<std::string, LinuxURLHost*> urlHosts;
+
+#if defined(OGALIB_USING_OPENSSL)
+static SSL_CTX* urlSSLContext = nullptr;
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+static bool URLPerformRequest(const std::string& url, const std::string& method, const json& params, bool sameOrigin, LinuxURLRequest& request, std::string& error);
+static std::string URLGetOrigin(const std::string& url);
+static std::string URLResolveLocation(const std::string& url, const std::string& location);
+static void* URLThread(void* param);
+static void URLTakeSubmitted();
+static void URLProcessCancelled();
+static void URLDispatch(LinuxURLHost* host);
+static bool URLOpenConnection(LinuxURLHost* host, LinuxURLRequest* request);
+static void URLStartRequest(LinuxURLConnection* conn, LinuxURLRequest* request);
+static void URLCloseConnection(LinuxURLConnection* conn);
+static void URLFailConnection(LinuxURLConnection* conn, const std::string& error, bool allowRetry = true);
+static void URLFinishRequest(LinuxURLConnection* conn);
+static void URLCompleteRequest(LinuxURLRequest* request, const std::string& error);
+static void URLSetEvents(LinuxURLConnection* conn, uint32_t events);
+static void URLProcessConnection(LinuxURLConnection* conn, uint32_t events);
+static void URLProcessTimeouts();
+static bool URLStartSecure(LinuxURLConnection* conn);
+static ssize_t URLConnectionRead(LinuxURLConnection* conn, void* p, size_t size);
+static ssize_t URLConnectionWrite(LinuxURLConnection* conn, const void* p, size_t size);
+static int URLParseResponse(LinuxURLConnection* conn);
+static bool URLResolveAddress(const std::string& hostKey, const std::string& hostName, int32_t port, LinuxURLAddress& address, std::string& error);
+static void URLForgetAddress(const std::string& hostKey);
+
+static __inline double GetURLTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1000000000.0;
+}
+
+static __inline bool URLHeaderNameEquals(const std::string& name, const char* value) {
+  return strcasecmp(name.c_str(), value) == 0;
+}
+
+static __inline bool URLHeaderValueContains(const std::string& headerValue, const char* value) {
+  return strcasestr(headerValue.c_str(), value) != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Functions
+////////////////////////////////////////////////////////////////////////////////
+
+DataLinux::DataLinux():
+urlMaxConnectionsPerHost(OGALIB_LINUX_URL_MAX_CONNECTIONS_PER_HOST),
+urlConnectTimeout(OGALIB_LINUX_URL_CONNECT_TIMEOUT),
+urlRequestTimeout(OGALIB_LINUX_URL_REQUEST_TIMEOUT),
+urlIdleConnectionTimeout(OGALIB_LINUX_URL_IDLE_CONNECTION_TIMEOUT) {
+
+}
+
+void ogalib::InitLinux() {
+  if(auto it = ogalibData.initParams.find("Linux.URLMaxConnectionsPerHost")) {
+    auto& value = it.value();
+    if(value.IsNumber() && value.GetUint64() > 0) {
+      ogalibDataLinux.urlMaxConnectionsPerHost = (size_t) value.GetUint64();
+    }
+  }
+
+  if(auto it = ogalibData.initParams.find("Linux.URLConnectTimeout")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      ogalibDataLinux.urlConnectTimeout = value.GetDouble();
+    }
+  }
+
+  if(auto it = ogalibData.initParams.find("Linux.URLRequestTimeout")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      ogalibDataLinux.urlRequestTimeout = value.GetDouble();
+    }
+  }
+
+  if(auto it = ogalibData.initParams.find("Linux.URLIdleConnectionTimeout")) {
+    auto& value = it.value();
+    if(value.IsNumber()) {
+      ogalibDataLinux.urlIdleConnectionTimeout = value.GetDouble();
+    }
+  }
+
+#if defined(OGALIB_USING_OPENSSL)
+  // OpenSSL writes to sockets directly, so a peer closing a connection would otherwise raise SIGPIPE.
+  signal(SIGPIPE, SIG_IGN);
+
+  urlSSLContext = SSL_CTX_new(TLS_client_method());
+  ogalibAssert(urlSSLContext, "Error in call to SSL_CTX_new.");
+  if(urlSSLContext) {
+    SSL_CTX_set_default_verify_paths(urlSSLContext);
+    SSL_CTX_set_mode(urlSSLContext, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+  }
+#endif
+
+  urlMutex = new ThreadMutex("ogalib::SendURL mutex");
+  urlAddressMutex = new ThreadMutex("ogalib::SendURL address mutex");
+
+  urlEpoll = epoll_create1(EPOLL_CLOEXEC);
+  ogalibAssert(urlEpoll >= 0, "Error in call to epoll_create1: %d", errno);
+
+  urlEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  ogalibAssert(urlEvent >= 0, "Error in call to eventfd: %d", errno);
+
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.ptr = nullptr;
+  epoll_ctl(urlEpoll, EPOLL_CTL_ADD, urlEvent, &event);
+
+  urlThreadActive = true;
+  urlThread = new Thread(URLThread, nullptr, "ogalib::SendURL thread");
+  if(!urlThread->Start()) {
+    ogalibAssert(false, "Could not start ogalib::SendURL thread.");
+  }
+}
+
+void ogalib::ShutdownLinux() {
+  if(urlThread) {
+    urlThreadActive = false;
+
+    uint64_t value = 1;
+    ssize_t result = write(urlEvent, &value, sizeof(value));
+    (void) result;
+
+    delete urlThread;
+    urlThread = nullptr;
+  }
+
+  if(urlEvent >= 0) {
+    close(urlEvent);
+    urlEvent = -1;
+  }
+
+  if(urlEpoll >= 0) {
+    close(urlEpoll);
+    urlEpoll = -1;
+  }
+
+  urlAddressCache.clear();
+
+  if(urlAddressMutex) {
+    delete urlAddressMutex;
+    urlAddressMutex = nullptr;
+  }
+
+  if(urlMutex) {
+    delete urlMutex;
+    urlMutex = nullptr;
+  }
+
+#if defined(OGALIB_USING_OPENSSL)
+  if(urlSSLContext) {
+    SSL_CTX_free(urlSSLContext);
+    urlSSLContext = nullptr;
+  }
+#endif
+}
+
+bool ogalib::SendURL(const std::string& url, const json& params, json& result, std::string& response, const CancelToken& cancel) {
+  if(!ogalibData.initialized) {
+    ogalibAssert(false, "ogalib is not initialized.");
+    return false;
+  }
+
+  if(url.size() == 0)
+    return false;
+
+  response.clear();
+
+  if(auto it = result.find("error")) {
+    result.erase(it);
+  }
+
+  result["statusCode"] = 0;
+  result["statusText"] = "";
+
+  if(cancel.IsCancelled()) {
+    result["error"] = OGALIB_LINUX_URL_CANCELLED;
+    result["cancelled"] = true;
+    return false;
+  }
+
+  std::string method;
+  if(auto it = params.find("method")) {
+    method = it.GetString();
+  }
+  else {
+    method = "GET";
+  }
+
+  std::string useURL = url;
+  std::string origin = URLGetOrigin(url);
+  size_t redirects = 0;
+
+  while(true) {
+    LinuxURLRequest request;
+    request.cancel = cancel;
+
+    std::string error;
+    if(!URLPerformRequest(useURL, method, params, URLGetOrigin(useURL) == origin, request, error)) {
+      result["error"] = error;
+      return false;
+    }
+
+    result["statusCode"] = request.statusCode;
+    result["statusText"] = request.statusText;
+    ParseURLResponseHeaders(request.responseHeaders.data(), request.responseHeaders.size(), result);
+
+    if(!request.error.empty()) {
+      result["error"] = request.error;
+      if(request.cancel.IsCancelled() && request.error == OGALIB_LINUX_URL_CANCELLED) {
+        result["cancelled"] = true;
+      }
+      return false;
+    }
+
+    int statusCode = request.statusCode;
+    bool redirect = statusCode == 301 || statusCode == 302 || statusCode == 303 || statusCode == 307 || statusCode == 308;
+    if(redirect && !request.location.empty()) {
+      if(redirects == OGALIB_LINUX_URL_MAX_REDIRECTS) {
+        result["error"] = string_printf("Too many redirects: %s", url.c_str());
+        return false;
+      }
+
+      useURL = URLResolveLocation(useURL, request.location);
+      if(statusCode == 303 && method != "HEAD") {
+        method = "GET";
+      }
+
+      redirects++;
+      continue;
+    }
+
+    if(statusCode != 200) {
+      result["error"] = string_printf("HTTP status code: %d", statusCode);
+      return false;
+    }
+
+    response.swap(request.response);
+    return true;
+  }
+}
+
+bool URLPerformRequest(const std::string& url, const std::string& method, const json& params, bool sameOrigin, LinuxURLRequest& request, std::string& error) {
+  static const std::string httpsPrefix("https://");
+  static const std::string httpPrefix("http://");
+
+  std::string server;
+  std::string urlPath;
+
+  if(url.rfind(httpsPrefix, 0) == 0) {
+    server = url.substr(httpsPrefix.size(), url.npos);
+    request.secure = true;
+  }
+  else if(url.rfind(httpPrefix, 0) == 0) {
+    server = url.substr(httpPrefix.size(), url.npos);
+    request.secure = false;
+  }
+
+  size_t pathIndex = server.find_first_of("/?");
+  if(pathIndex != server.npos) {
+    urlPath = server.substr(pathIndex);
+    server = server.substr(0, pathIndex);
+  }
+
+  if(urlPath.empty() || urlPath[0] != '/') {
+    urlPath.insert(0, "/");
+  }
+
+  if(server.size() == 0) {
+    error = string_printf("Unhandled URL format: %s", url.c_str());
+    return false;
+  }
+
+#if !defined(OGALIB_USING_OPENSSL)
+  if(request.secure) {
+    error = string_printf("HTTPS requires OGALIB_USING_OPENSSL: %s", url.c_str());
+    return false;
+  }
+#endif
+
+  int32_t port = request.secure ? 443 : 80;
+  size_t portIndex = server.rfind(':');
+  if(portIndex != server.npos && server.find(']', portIndex) == server.npos) {
+    port = atoi(server.substr(portIndex + 1).c_str());
+    server = server.substr(0, portIndex);
+  }
+
+  // The port and credentials in params only apply to the requested origin, not to where it redirects.
+  if(auto it = params.find("port")) {
+    auto& value = it.value();
+    if(value.IsNumber() && sameOrigin) {
+      port = value.GetUint();
+    }
+  }
+
+  request.hostName = server;
+  if(request.hostName.size() > 2 && request.hostName.front() == '[' && request.hostName.back() == ']') {
+    request.hostName = request.hostName.substr(1, request.hostName.size() - 2);
+  }
+
+  if(auto it = params.find("ignoreSSLErrors")) {
+    auto& value = it.value();
+    if(value.IsBool()) {
+      request.ignoreSSLErrors = value.GetBool();
+    }
+  }
+
+  if(auto it = params.find("skipResponseData")) {
+    auto& value = it.value();
+    if(value.IsBool()) {
+      request.skipResponseData = value.GetBool();
+    }
+  }
+
+  // Connections are only shared between requests with matching certificate verification.
+  request.hostKey = string_printf("%s://%s:%d%s", request.secure ? "https" : "http", server.c_str(), port, request.secure && request.ignoreSSLErrors ? "/insecure" : "");
+
+  if(!URLResolveAddress(request.hostKey, request.hostName, port, request.address, error))
+    return false;
+
+  request.noResponseBody = method == "HEAD";
+
+  size_t dataSize = 0;
+  const void* data = nullptr;
+  if(auto it = params.find("data")) {
+    if(method == "POST") {
+      data = it.GetStringData(&dataSize);
+    }
+  }
+
+  std::string& requestData = request.requestData;
+  requestData.reserve(urlPath.size() + server.size() + dataSize + 256);
+  requestData += method;
+  requestData += " ";
+  requestData += urlPath;
+  requestData += " HTTP/1.1\r\nHost: ";
+  requestData += server;
+  if(port != (request.secure ? 443 : 80)) {
+    requestData += string_printf(":%d", port);
+  }
+  requestData += "\r\nUser-Agent: " OGALIB_LINUX_URL_HTTP_USER_AGENT "\r\nAccept: */*\r\nConnection: keep-alive\r\n";
+
+  if(sameOrigin) {
+    if(auto it = params.find("authorizationBearerToken")) {
+      std::string authorizationBearerToken = it.GetString();
+      if(authorizationBearerToken.length() > 0) {
+        requestData += string_printf("Authorization: Bearer %s\r\n", authorizationBearerToken.c_str());
+      }
+    }
+  }
+
+  if(auto it = params.find("headers")) {
+    for(auto& header: it) {
+      requestData += string_printf("%s: %s\r\n", header.key().GetString(), header.GetString().c_str());
+    }
+  }
+
+  if(data && dataSize > 0) {
+    if(auto it = params.find("contentType")) {
+      requestData += string_printf("Content-Type: %s\r\n", it.GetString().c_str());
+    }
+    else {
+      requestData += "Content-Type: application/x-www-form-urlencoded\r\n";
+    }
+    requestData += string_printf("Content-Length: %zu\r\n\r\n", dataSize);
+    requestData.append((const char*) data, dataSize);
+  }
+  else if(method == "POST") {
+    requestData += "Content-Length: 0\r\n\r\n";
+  }
+  else {
+    requestData += "\r\n";
+  }
+
+  urlMutex->Lock();
+  urlSubmitted.push_back(&request);
+  urlMutex->Unlock();
+
+  uint64_t value = 1;
+  ssize_t writeResult = write(urlEvent, &value, sizeof(value));
+  (void) writeResult;
+
+  // Wake the URL thread so it drops the request, or closes its connection mid-transfer.
+  size_t cancelId = request.cancel.OnCancel([]() {
+    urlCancelPending = true;
+
+    uint64_t value = 1;
+    ssize_t writeResult = write(urlEvent, &value, sizeof(value));
+    (void) writeResult;
+  });
+
+  {
+    ThreadConditionLock lock(request.condition);
+    while(request.wait) {
+      request.condition.Wait();
+    }
+  }
+
+  request.cancel.RemoveOnCancel(cancelId);
+
+  return true;
+}
+
+std::string URLGetOrigin(const std::string& url) {
+  size_t schemeEnd = url.find("://");
+  if(schemeEnd == url.npos)
+    return std::string();
+
+  return url.substr(0, url.find_first_of("/?#", schemeEnd + 3));
+}
+
+std::string URLResolveLocation(const std::string& url, const std::string& location) {
+  std::string useLocation = location.substr(0, location.find('#'));
+
+  if(useLocation.find("://") != useLocation.npos)
+    return useLocation;
+
+  if(useLocation.rfind("//", 0) == 0)
+    return url.substr(0, url.find("://") + 1) + useLocation;
+
+  std::string origin = URLGetOrigin(url);
+  if(useLocation.empty() || useLocation[0] == '/')
+    return origin + useLocation;
+
+  std::string path = url.substr(origin.size());
+  path = path.substr(0, path.find_first_of("?#"));
+  if(useLocation[0] == '?')
+    return origin + (path.empty() ? "/" : path) + useLocation;
+
+  size_t slash = path.rfind('/');
+  path = slash == path.npos ? "/" : path.substr(0, slash + 1);
+
+  return origin + path + useLocation;
+}
+
+void* URLThread(void* param) {
+  epoll_event events[OGALIB_LINUX_URL_EPOLL_EVENT_COUNT];
+
+  while(urlThreadActive) {
+    int eventCount = epoll_wait(urlEpoll, events, OGALIB_LINUX_URL_EPOLL_EVENT_COUNT, OGALIB_LINUX_URL_EPOLL_WAIT_TIMEOUT);
+
+    for(int i = 0; i < eventCount; i++) {
+      LinuxURLConnection* conn = static_cast<LinuxURLConnection*>(events[i].data.ptr);
+      if(conn) {
+        URLProcessConnection(conn, events[i].events);
+      }
+      else {
+        uint64_t value;
+        ssize_t readResult = read(urlEvent, &value, sizeof(value));
+        (void) readResult;
+      }
+    }
+
+    URLTakeSubmitted();
+
+    if(urlCancelPending.exchange(false)) {
+      URLProcessCancelled();
+    }
+
+    URLProcessTimeouts();
+  }
+
+  // Fail anything that is still queued or in flight so no caller is left waiting.
+  URLTakeSubmitted();
+
+  for(auto& it: urlHosts) {
+    LinuxURLHost* host = it.second;
+
+    while(!host->connections.empty()) {
+      LinuxURLConnection* conn = host->connections.back();
+      LinuxURLRequest* request = conn->request;
+      conn->request = nullptr;
+      URLCloseConnection(conn);
+
+      if(request) {
+        URLCompleteRequest(request, "ogalib is shutting down.");
+      }
+    }
+
+    for(auto request: host->pending) {
+      URLCompleteRequest(request, "ogalib is shutting down.");
+    }
+    host->pending.clear();
+
+    delete host;
+  }
+
+  urlHosts.clear();
+
+  return nullptr;
+}
+
+void URLTakeSubmitted() {
+  std::deque<LinuxURLRequest*> submitted;
+
+  urlMutex->Lock();
+  submitted.swap(urlSubmitted);
+  urlMutex->Unlock();
+
+  std::vector<LinuxURLHost*> dispatchHosts;
+
+  for(auto request: submitted) {
+    LinuxURLHost* host;
+
+    auto it = urlHosts.find(request->hostKey);
+    if(it == urlHosts.end()) {
+      host = new LinuxURLHost();
+      host->key = request->hostKey;
+      urlHosts[host->key] = host;
+    }
+    else {
+      host = it->second;
+    }
+
+    host->pending.push_back(request);
+
+    if(std::find(dispatchHosts.begin(), dispatchHosts.end(), host) == dispatchHosts.end()) {
+      dispatchHosts.push_back(host);
+    }
+  }
+
+  for(auto host: dispatchHosts) {
+    URLDispatch(host);
+  }
+}
+
+void URLProcessCancelled() {
+  for(auto& it: urlHosts) {
+    LinuxURLHost* host = it.second;
+
+    for(auto itPending = host->pending.begin(); itPending != host->pending.end();) {
+      LinuxURLRequest* request = *itPending;
+      if(request->cancel.IsCancelled()) {
+        itPending = host->pending.erase(itPending);
+        URLCompleteRequest(request, OGALIB_LINUX_URL_CANCELLED);
+      }
+      else {
+        ++itPending;
+      }
+    }
+
+    std::vector<LinuxURLConnection*> cancelled;
+    for(auto conn: host->connections) {
+      if(conn->request && conn->request->cancel.IsCancelled()) {
+        cancelled.push_back(conn);
+      }
+    }
+
+    // The rest of the response is still on the wire, so the connection cannot be reused.
+    for(auto conn: cancelled) {
+      LinuxURLRequest* request = conn->request;
+      conn->request = nullptr;
+      URLCloseConnection(conn);
+      URLCompleteRequest(request, OGALIB_LINUX_URL_CANCELLED);
+    }
+
+    if(!cancelled.empty()) {
+      URLDispatch(host);
+    }
+  }
+}
+
+void URLDispatch(LinuxURLHost* host) {
+  while(!host->pending.empty()) {
+    LinuxURLConnection* idleConn = nullptr;
+    for(auto conn: host->connections) {
+      if(conn->state == LinuxURLConnectionState::Idle) {
+        idleConn = conn;
+        break;
+      }
+    }
+
+    if(idleConn) {
+      LinuxURLRequest* request = host->pending.front();
+      host->pending.pop_front();
+      URLStartRequest(idleConn, request);
+    }
+    else if(host->connections.size() < ogalibDataLinux.urlMaxConnectionsPerHost) {
+      LinuxURLRequest* request = host->pending.front();
+      host->pending.pop_front();
+
+      if(!URLOpenConnection(host, request)) {
+        URLForgetAddress(host->key);
+        URLCompleteRequest(request, string_printf("Could not connect to %s.", host->key.c_str()));
+      }
+    }
+    else {
+      break;
+    }
+  }
+}
+
+bool URLOpenConnection(LinuxURLHost* host, LinuxURLRequest* request) {
+  int fd = socket(request->address.address.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+  if(fd < 0) {
+    return false;
+  }
+
+  int noDelay = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+  if(connect(fd, (const sockaddr*) &request->address.address, request->address.addressSize) != 0 && errno != EINPROGRESS) {
+    close(fd);
+    return false;
+  }
+
+  LinuxURLConnection* conn = new LinuxURLConnection(host, fd);
+  conn->request = request;
+  conn->deadline = GetURLTime() + ogalibDataLinux.urlConnectTimeout;
+  request->attempts++;
+
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLOUT;
+  event.data.ptr = conn;
+  if(epoll_ctl(urlEpoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+    close(fd);
+    delete conn;
+    return false;
+  }
+
+  conn->events = EPOLLOUT;
+  host->connections.push_back(conn);
+
+  return true;
+}
+
+void URLStartRequest(LinuxURLConnection* conn, LinuxURLRequest* request) {
+  conn->request = request;
+  conn->requestDataSent = 0;
+  conn->receivedResponseData = false;
+  conn->state = LinuxURLConnectionState::Sending;
+  conn->deadline = GetURLTime() + ogalibDataLinux.urlRequestTimeout;
+  request->attempts++;
+
+  URLSetEvents(conn, EPOLLOUT);
+}
+
+void URLCloseConnection(LinuxURLConnection* conn) {
+  LinuxURLHost* host = conn->host;
+
+  auto it = std::find(host->connections.begin(), host->connections.end(), conn);
+  if(it != host->connections.end()) {
+    host->connections.erase(it);
+  }
+
+  epoll_ctl(urlEpoll, EPOLL_CTL_DEL, conn->fd, nullptr);
+
+#if defined(OGALIB_USING_OPENSSL)
+  if(conn->ssl) {
+    SSL_free(conn->ssl);
+    conn->ssl = nullptr;
+  }
+#endif
+
+  close(conn->fd);
+  delete conn;
+}
+
+void URLFailConnection(LinuxURLConnection* conn, const std::string& error, bool allowRetry) {
+  LinuxURLHost* host = conn->host;
+  LinuxURLRequest* request = conn->request;
+
+  // A pooled connection may have been closed by the server while idle.  Retry once on a fresh connection.
+  bool retry = allowRetry && request && conn->reused && !conn->receivedResponseData && request->attempts < OGALIB_LINUX_URL_MAX_ATTEMPTS;
+
+  if(conn->state == LinuxURLConnectionState::Connecting) {
+    URLForgetAddress(host->key);
+  }
+
+  conn->request = nullptr;
+  URLCloseConnection(conn);
+
+  if(request) {
+    if(retry) {
+      request->response.clear();
+      request->responseHeaders.clear();
+      request->statusCode = 0;
+      request->statusText.clear();
+      host->pending.push_front(request);
+    }
+    else {
+      URLCompleteRequest(request, error);
+    }
+  }
+
+  URLDispatch(host);
+}
+
+void URLFinishRequest(LinuxURLConnection* conn) {
+  LinuxURLHost* host = conn->host;
+  LinuxURLRequest* request = conn->request;
+  bool keepAlive = conn->keepAlive && conn->recvBuffer.empty();
+
+  conn->request = nullptr;
+
+  if(keepAlive) {
+    conn->state = LinuxURLConnectionState::Idle;
+    conn->reused = true;
+    conn->deadline = GetURLTime() + ogalibDataLinux.urlIdleConnectionTimeout;
+    URLSetEvents(conn, EPOLLIN);
+  }
+  else {
+    URLCloseConnection(conn);
+  }
+
+  URLCompleteRequest(request, std::string());
+  URLDispatch(host);
+}
+
+void URLCompleteRequest(LinuxURLRequest* request, const std::string& error) {
+  request->error = error;
+
+  // The request belongs to the waiting thread and must not be touched after this signal.
+  request->condition.Signal(request->wait);
+}
+
+void URLSetEvents(LinuxURLConnection* conn, uint32_t events) {
+  if(conn->events == events)
+    return;
+
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = events;
+  event.data.ptr = conn;
+  epoll_ctl(urlEpoll, EPOLL_CTL_MOD, conn->fd, &event);
+
+  conn->events = events;
+}
+
+void URLProcessConnection(LinuxURLConnection* conn, uint32_t events) {
+  if(conn->state == LinuxURLConnectionState::Idle) {
+    // Idle connections only become readable when the server closes them.
+    URLCloseConnection(conn);
+    return;
+  }
+
+  if(conn->state == LinuxURLConnectionState::Connecting) {
+    int err = 0;
+    socklen_t errSize = sizeof(err);
+    if(getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &err, &errSize) != 0 || err != 0) {
+      URLFailConnection(conn, string_printf("Could not connect to %s (error %d).", conn->host->key.c_str(), err), false);
+      return;
+    }
+
+    if(conn->request->secure) {
+      if(!URLStartSecure(conn)) {
+        URLFailConnection(conn, "Could not start a secure connection.", false);
+        return;
+      }
+
+      conn->state = LinuxURLConnectionState::Handshaking;
+    }
+    else {
+      conn->state = LinuxURLConnectionState::Sending;
+      conn->deadline = GetURLTime() + ogalibDataLinux.urlRequestTimeout;
+    }
+  }
+
+#if defined(OGALIB_USING_OPENSSL)
+  if(conn->state == LinuxURLConnectionState::Handshaking) {
+    ERR_clear_error();
+    int sslResult = SSL_connect(conn->ssl);
+    if(sslResult == 1) {
+      conn->state = LinuxURLConnectionState::Sending;
+      conn->deadline = GetURLTime() + ogalibDataLinux.urlRequestTimeout;
+    }
+    else {
+      int sslError = SSL_get_error(conn->ssl, sslResult);
+      if(sslError == SSL_ERROR_WANT_READ) {
+        URLSetEvents(conn, EPOLLIN);
+        return;
+      }
+      else if(sslError == SSL_ERROR_WANT_WRITE) {
+        URLSetEvents(conn, EPOLLOUT);
+        return;
+      }
+      else {
+        URLFailConnection(conn, string_printf("Error %d in SSL_connect (%s).", sslError, ERR_reason_error_string(ERR_peek_last_error())), false);
+        return;
+      }
+    }
+  }
+#endif
+
+  if(conn->state == LinuxURLConnectionState::Sending) {
+    LinuxURLRequest* request = conn->request;
+
+    while(conn->requestDataSent < request->requestData.size()) {
+      ssize_t sent = URLConnectionWrite(conn, request->requestData.data() + conn->requestDataSent, request->requestData.size() - conn->requestDataSent);
+      if(sent > 0) {
+        conn->requestDataSent += sent;
+      }
+      else if(sent == URLWouldBlock) {
+        return;
+      }
+      else {
+        URLFailConnection(conn, "Error sending request.");
+        return;
+      }
+    }
+
+    conn->state = LinuxURLConnectionState::Receiving;
+    conn->parseState = LinuxURLParseState::StatusLine;
+    conn->recvBuffer.clear();
+    conn->contentLength = -1;
+    conn->chunkRemaining = 0;
+    conn->chunked = false;
+    conn->keepAlive = false;
+    URLSetEvents(conn, EPOLLIN);
+
+    // Wait for the response to arrive.
+    return;
+  }
+
+  if(conn->state == LinuxURLConnectionState::Receiving) {
+    char buffer[OGALIB_LINUX_URL_RECV_BUFFER_SIZE];
+
+    while(true) {
+      ssize_t received = URLConnectionRead(conn, buffer, sizeof(buffer));
+      if(received > 0) {
+        conn->receivedResponseData = true;
+        conn->recvBuffer.append(buffer, received);
+        conn->deadline = GetURLTime() + ogalibDataLinux.urlRequestTimeout;
+
+        int parseResult = URLParseResponse(conn);
+        if(parseResult < 0) {
+          URLFailConnection(conn, "Invalid HTTP response.", false);
+          return;
+        }
+        else if(parseResult > 0) {
+          URLFinishRequest(conn);
+          return;
+        }
+      }
+      else if(received == URLWouldBlock) {
+        return;
+      }
+      else if(received == 0 && conn->parseState == LinuxURLParseState::Body && conn->contentLength < 0 && !conn->chunked) {
+        // Responses without a length are terminated by closing the connection.
+        conn->keepAlive = false;
+        URLFinishRequest(conn);
+        return;
+      }
+      else {
+        URLFailConnection(conn, received == 0 ? "Connection closed by server." : "Error receiving response.");
+        return;
+      }
+    }
+  }
+}
+
+void URLProcessTimeouts() {
+  double now = GetURLTime();
+  std::vector<LinuxURLConnection*> expired;
+
+  for(auto& it: urlHosts) {
+    for(auto conn: it.second->connections) {
+      if(now > conn->deadline) {
+        expired.push_back(conn);
+      }
+    }
+  }
+
+  for(auto conn: expired) {
+    if(conn->state == LinuxURLConnectionState::Idle) {
+      URLCloseConnection(conn);
+    }
+    else {
+      URLFailConnection(conn, "Request timed out.", false);
+    }
+  }
+}
+
+bool URLStartSecure(LinuxURLConnection* conn) {
+#if defined(OGALIB_USING_OPENSSL)
+  LinuxURLRequest* request = conn->request;
+
+  if(!urlSSLContext)
+    return false;
+
+  conn->ssl = SSL_new(urlSSLContext);
+  if(!conn->ssl)
+    return false;
+
+  SSL_set_fd(conn->ssl, conn->fd);
+  SSL_set_tlsext_host_name(conn->ssl, request->hostName.c_str());
+
+  if(request->ignoreSSLErrors) {
+    SSL_set_verify(conn->ssl, SSL_VERIFY_NONE, nullptr);
+  }
+  else {
+    SSL_set_verify(conn->ssl, SSL_VERIFY_PEER, nullptr);
+    SSL_set1_host(conn->ssl, request->hostName.c_str());
+  }
+
+  SSL_set_connect_state(conn->ssl);
+
+  return true;
+#else
+  return false;
+#endif
+}
+
+ssize_t URLConnectionRead(LinuxURLConnection* conn, void* p, size_t size) {
+#if defined(OGALIB_USING_OPENSSL)
+  if(conn->ssl) {
+    ERR_clear_error();
+    int result = SSL_read(conn->ssl, p, (int) size);
+    if(result > 0)
+      return result;
+
+    int sslError = SSL_get_error(conn->ssl, result);
+    if(sslError == SSL_ERROR_WANT_READ) {
+      URLSetEvents(conn, EPOLLIN);
+      return URLWouldBlock;
+    }
+    else if(sslError == SSL_ERROR_WANT_WRITE) {
+      URLSetEvents(conn, EPOLLIN | EPOLLOUT);
+      return URLWouldBlock;
+    }
+    else if(sslError == SSL_ERROR_ZERO_RETURN || (sslError == SSL_ERROR_SYSCALL && ERR_peek_error() == 0)) {
+      return 0;
+    }
+    else {
+      return URLError;
+    }
+  }
+#endif
+
+  ssize_t result = recv(conn->fd, p, size, 0);
+  if(result >= 0)
+    return result;
+  else if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+    return URLWouldBlock;
+  else
+    return URLError;
+}
+
+ssize_t URLConnectionWrite(LinuxURLConnection* conn, const void* p, size_t size) {
+#if defined(OGALIB_USING_OPENSSL)
+  if(conn->ssl) {
+    ERR_clear_error();
+    int result = SSL_write(conn->ssl, p, (int) size);
+    if(result > 0)
+      return result;
+
+    int sslError = SSL_get_error(conn->ssl, result);
+    if(sslError == SSL_ERROR_WANT_WRITE) {
+      URLSetEvents(conn, EPOLLOUT);
+      return URLWouldBlock;
+    }
+    else if(sslError == SSL_ERROR_WANT_READ) {
+      URLSetEvents(conn, EPOLLIN);
+      return URLWouldBlock;
+    }
+    else {
+      return URLError;
+    }
+  }
+#endif
+
+  ssize_t result = send(conn->fd, p, size, MSG_NOSIGNAL);
+  if(result > 0) {
+    return result;
+  }
+  else if(result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    URLSetEvents(conn, EPOLLOUT);
+    return URLWouldBlock;
+  }
+  else {
+    return URLError;
+  }
+}
+
+// Returns 1 when the response is complete, 0 when more data is needed, or -1 on a malformed response.
+int URLParseResponse(LinuxURLConnection* conn) {
+  LinuxURLRequest* request = conn->request;
+  std::string& buffer = conn->recvBuffer;
+  size_t pos = 0;
+  int result = 0;
+
+  while(result == 0) {
+    if(conn->parseState == LinuxURLParseState::StatusLine || conn->parseState == LinuxURLParseState::Headers || conn->parseState == LinuxURLParseState::ChunkSize || conn->parseState == LinuxURLParseState::Trailers) {
+      size_t lineEnd = buffer.find("\r\n", pos);
+      if(lineEnd == buffer.npos)
+        break;
+
+      std::string line = buffer.substr(pos, lineEnd - pos);
+      pos = lineEnd + 2;
+
+      if(conn->parseState == LinuxURLParseState::StatusLine) {
+        int versionMinor = 0;
+        int statusCode = 0;
+        int statusTextOffset = 0;
+        if(sscanf(line.c_str(), "HTTP/1.%d %d %n", &versionMinor, &statusCode, &statusTextOffset) < 2) {
+          result = -1;
+          break;
+        }
+
+        request->statusCode = statusCode;
+        request->statusText = statusTextOffset > 0 ? line.substr(statusTextOffset) : std::string();
+        request->responseHeaders.clear();
+        request->location.clear();
+        conn->keepAlive = versionMinor >= 1;
+        conn->contentLength = -1;
+        conn->chunked = false;
+        conn->parseState = LinuxURLParseState::Headers;
+      }
+      else if(conn->parseState == LinuxURLParseState::Headers) {
+        if(line.empty()) {
+          int statusCode = request->statusCode;
+          if(statusCode >= 100 && statusCode < 200) {
+            // Interim response, the final status line follows.
+            conn->parseState = LinuxURLParseState::StatusLine;
+          }
+          else if(request->noResponseBody || statusCode == 204 || statusCode == 304) {
+            conn->parseState = LinuxURLParseState::Done;
+          }
+          else if(conn->chunked) {
+            conn->parseState = LinuxURLParseState::ChunkSize;
+          }
+          else if(conn->contentLength == 0) {
+            conn->parseState = LinuxURLParseState::Done;
+          }
+          else {
+            if(conn->contentLength < 0) {
+              conn->keepAlive = false;
+            }
+            else if(!request->skipResponseData) {
+              request->response.reserve((size_t) conn->contentLength);
+            }
+            conn->parseState = LinuxURLParseState::Body;
+          }
+        }
+        else {
+          request->responseHeaders += line;
+          request->responseHeaders += "\r\n";
+
+          size_t colon = line.find(':');
+          if(colon != line.npos) {
+            std::string name = line.substr(0, colon);
+            size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+            std::string value = valueStart == line.npos ? std::string() : line.substr(valueStart);
+
+            if(URLHeaderNameEquals(name, "Content-Length")) {
+              conn->contentLength = strtoll(value.c_str(), nullptr, 10);
+            }
+            else if(URLHeaderNameEquals(name, "Transfer-Encoding")) {
+              conn->chunked = URLHeaderValueContains(value, "chunked");
+            }
+            else if(URLHeaderNameEquals(name, "Location")) {
+              request->location = value;
+            }
+            else if(URLHeaderNameEquals(name, "Connection")) {
+              if(URLHeaderValueContains(value, "close")) {
+                conn->keepAlive = false;
+              }
+              else if(URLHeaderValueContains(value, "keep-alive")) {
+                conn->keepAlive = true;
+              }
+            }
+          }
+        }
+      }
+      else if(conn->parseState == LinuxURLParseState::ChunkSize) {
+        char* end = nullptr;
+        conn->chunkRemaining = strtoull(line.c_str(), &end, 16);
+        if(end == line.c_str()) {
+          result = -1;
+          break;
+        }
+
+        conn->parseState = conn->chunkRemaining == 0 ? LinuxURLParseState::Trailers : LinuxURLParseState::ChunkData;
+      }
+      else if(conn->parseState == LinuxURLParseState::Trailers) {
+        if(line.empty()) {
+          conn->parseState = LinuxURLParseState::Done;
+        }
+      }
+    }
+    else if(conn->parseState == LinuxURLParseState::Body) {
+      size_t available = buffer.size() - pos;
+      if(available == 0)
+        break;
+
+      size_t useSize = available;
+      if(conn->contentLength >= 0) {
+        useSize = std::min(available, (size_t) conn->contentLength);
+        conn->contentLength -= useSize;
+      }
+
+      if(!request->skipResponseData) {
+        request->response.append(buffer, pos, useSize);
+      }
+      pos += useSize;
+
+      if(conn->contentLength == 0) {
+        conn->parseState = LinuxURLParseState::Done;
+      }
+    }
+    else if(conn->parseState == LinuxURLParseState::ChunkData) {
+      size_t available = buffer.size() - pos;
+      if(available == 0)
+        break;
+
+      size_t useSize = (size_t) std::min((uint64_t) available, conn->chunkRemaining);
+      if(!request->skipResponseData) {
+        request->response.append(buffer, pos, useSize);
+      }
+      pos += useSize;
+      conn->chunkRemaining -= useSize;
+
+      if(conn->chunkRemaining == 0) {
+        conn->parseState = LinuxURLParseState::ChunkDataEnd;
+      }
+    }
+    else if(conn->parseState == LinuxURLParseState::ChunkDataEnd) {
+      if(buffer.size() - pos < 2)
+        break;
+
+      if(buffer.compare(pos, 2, "\r\n") != 0) {
+        result = -1;
+        break;
+      }
+
+      pos += 2;
+      conn->parseState = LinuxURLParseState::ChunkSize;
+    }
+    else if(conn->parseState == LinuxURLParseState::Done) {
+      result = 1;
+    }
+  }
+
+  buffer.erase(0, pos);
+
+  return result;
+}
+
+bool URLResolveAddress(const std::string& hostKey, const std::string& hostName, int32_t port, LinuxURLAddress& address, std::string& error) {
+  urlAddressMutex->Lock();
+  auto it = urlAddressCache.find(hostKey);
+  if(it != urlAddressCache.end()) {
+    address = it->second;
+    urlAddressMutex->Unlock();
+    return true;
+  }
+  urlAddressMutex->Unlock();
+
+  addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+
+  addrinfo* addrs = nullptr;
+  int err = getaddrinfo(hostName.c_str(), std::to_string(port).c_str(), &hints, &addrs);
+  if(err != 0 || !addrs) {
+    error = string_printf("Could not resolve %s: %s", hostName.c_str(), gai_strerror(err));
+    return false;
+  }
+
+  memset(&address.address, 0, sizeof(address.address));
+  memcpy(&address.address, addrs->ai_addr, addrs->ai_addrlen);
+  address.addressSize = (socklen_t) addrs->ai_addrlen;
+  freeaddrinfo(addrs);
+
+  urlAddressMutex->Lock();
+  urlAddressCache[hostKey] = address;
+  urlAddressMutex->Unlock();
+
+  return true;
+}
+
+void URLForgetAddress(const std::string& hostKey) {
+  urlAddressMutex->Lock();
+  urlAddressCache.erase(hostKey);
+  urlAddressMutex->Unlock();
+}
+
+#endif
@@ -250,7 +250,7 @@ void ogalib::LoginUsingPS5(std::function<void(const json&)> callback) {
 
       std::string url = string_printf("%s/Login/v1/%s", ogalibData.baseAPI.c_str(), params.c_str()).c_str();
       SendURL(url.c_str(), sendURLParams, [=](const json& response) {
-        ogalibData.loginInProgress = false;
+        ogalibData.SetLoginInProgress(false);
 
         if(auto it = response.find("error")) {
           if(callback) {
@@ -340,7 +340,7 @@ void ogalib::LoginUsingPS5(std::function<void(const json&)> callback) {
       });
     }
     else {
-      ogalibData.loginInProgress = false;
+      ogalibData.SetLoginInProgress(false);
 
       if(callback) {
         callback({
@@ -348,10 +348,10 @@ void ogalib::LoginUsingPS5(std::function<void(const json&)> callback) {
         });
       }
     }
-  });
+  }, JobType::IO);
 }
 
-bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
+bool ogalib::SendURL(const std::string& url, const json& params, json& result, std::string& response, const CancelToken& cancel) {
   if(!ogalibData.initialized) {
     ogalibAssert(false, "ogalib is not initialized.");
     return false;
@@ -365,11 +365,18 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   int requestId = 0;
   int statusCode = 0;
   int err;
-  std::string response;
+
+  response.clear();
 
   result["statusCode"] = 0;
   result["statusText"] = "";
 
+  if(cancel.IsCancelled()) {
+    result["error"] = "Cancelled.";
+    result["cancelled"] = true;
+    return false;
+  }
+
   err = sceHttpCreateTemplate(ogalibDataPS5.httpContextId, OGALIB_PS5_URL_HTTP_USER_AGENT, SCE_HTTP_VERSION_1_1, SCE_TRUE);
   if(err < 0) {
     ogalib_dbgprintf("Error in call to sceHttpCreateTemplate: 0x%08X\n", err);
@@ -444,6 +451,15 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
       }
     }
 
+    if(auto it = params.find("headers")) {
+      for(auto& header: it) {
+        err = sceHttpAddRequestHeader(requestId, header.key().GetString(), header.GetString().c_str(), SCE_HTTP_HEADER_OVERWRITE);
+        if(err < 0) {
+          ogalib_dbgprintf("Error in call to sceHttpAddRequestHeader: 0x%08X\n", err);
+        }
+      }
+    }
+
     bool ignoreSSLErrors;
     if(auto it = params.find("ignoreSSLErrors")) {
       ignoreSSLErrors = it.GetBool();
@@ -557,6 +573,12 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
       result["statusCode"] = statusCode;
 
       // todo: sceHttpGetAllResponseHeaders for statusText
+      char* headers = nullptr;
+      size_t headersSize = 0;
+      err = sceHttpGetAllResponseHeaders(requestId, &headers, &headersSize);
+      if(err >= 0 && headers) {
+        ParseURLResponseHeaders(headers, headersSize, result);
+      }
 
       int contentLengthType;
       uint64_t contentLength;
@@ -581,6 +603,12 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
                 else if(err > 0) {
                   response.append(recvBuff, err);
                   go = true;
+
+                  if(cancel.IsCancelled()) {
+                    result["error"] = "Cancelled.";
+                    result["cancelled"] = true;
+                    break;
+                  }
                 }
                 else if(err == SCE_OK) {
                   break;
@@ -606,6 +634,12 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
               else if(err > 0) {
                 response.append(recvBuff, err);
                 go = true;
+
+                if(cancel.IsCancelled()) {
+                  result["error"] = "Cancelled.";
+                  result["cancelled"] = true;
+                  break;
+                }
               }
               else if(err == SCE_OK) {
                 break;
@@ -643,14 +677,15 @@ bool ogalib::SendURL(const std::string& url, const json& params, json& result) {
   if(auto itError = result.find("error")) {
     resultValue = false;
   }
-  else if(statusCode == 200) {
-    result["response"] = response;
-  }
-  else {
+  else if(statusCode != 200) {
     result["error"] = string_printf("HTTP status code: %d", statusCode);
     resultValue = false;
   }
 
+  if(!resultValue) {
+    response.clear();
+  }
+
   return resultValue;
 }
 